@@ -1,37 +1,92 @@
 #include <Arduino.h>
-#include <elapsedMillis.h>
 
 #ifndef _PB_TYPES
 #define _PB_TYPES
 
+  /* Code placement on Teensy 4.x: the scan path (update(), etc.) is placed in ITCM with FASTRUN, and cold configuration 
+      code is left in flash with FLASHMEM to save ITCM. Pushbutton state is in DTCM when the objects are declared as 
+      globals (not DMAMEM or heap). Checked at build time by scripts/check_placement.py.
+  */
+#if defined(__IMXRT1062__)
+#define PB_FASTRUN FASTRUN
+#define PB_FLASHMEM FLASHMEM
+#else
+#define PB_FASTRUN
+#define PB_FLASHMEM
+#endif
+
   // Default delay values; can be changed with setDelays()
 const uint16_t defDebouncePeriod = 80;   // default switch debounce period (ms)
 const uint16_t defDoubleTapDelay = 300;   // default max delay between first and second press (ms)
 const uint16_t defLongPressDur = 1000;    // default min duration of long press (ms)
 
+#ifdef PB_EDGE_CAPTURE
+const uint8_t edgeFifoSize = 8;   // number of timestamped edges buffered per pushbutton (must be a power of 2)
+#endif
+
   /* Pushbutton switch states:
       RDY: Waiting for new button press
       WAIT_LONG: Button pressed, waiting for long-press duration or for button to go inactive before possible 2nd tap
       WAIT_DOUBLE: Button released, waiting for possible 2nd tap 
       WAIT_INACTIVE: Waiting for button to be released before returning to RDY state
+      WAIT_DOUBLE_HOLD: Button pressed a second time, waiting for long-press duration or for button to go inactive
+        (only used when compiled with PB_DOUBLE_TAP_HOLD)
   */
-enum stateEnum {RDY, WAIT_LONG, WAIT_DOUBLE, WAIT_INACTIVE};
+enum stateEnum {RDY, WAIT_LONG, WAIT_DOUBLE, WAIT_INACTIVE, WAIT_DOUBLE_HOLD};
 
   /* Pushbutton switch events:
       NO_PRESS: No event yet, or previous event was read/cleared
       SINGLE_TAP: Button was pressed once and released
       DOUBLE_TAP:  Button was pressed twice with required timing
       LONG_PRESS: Button was pressed once and held for required duration
+      DOUBLE_TAP_HOLD: Button was tapped, then pressed again with double-tap timing and held for the long-press duration
+        (only detected when compiled with PB_DOUBLE_TAP_HOLD)
+  */
+enum eventEnum {NO_PRESS = 0b0000, SINGLE_TAP = 0b0001, DOUBLE_TAP = 0b0010, LONG_PRESS = 0b0100, DOUBLE_TAP_HOLD = 0b1000};
+
+class pushButtonRingClass;   // see PushbuttonRing.h
+
+  /* Operation counts, recorded when compiled with PB_INSTRUMENT defined (otherwise the counting code is compiled out).
+      Used to check the CPU and power cost of update(), e.g. that port-wide reads and shared timestamps take effect.
+      Each pushbutton counts the reads it makes itself; reads shared by several pushbuttons (a bank's port-wide read and
+      timestamp, or a sampler's DMA samples) are only counted in pbTotalOps.
   */
-enum eventEnum {NO_PRESS = 0b000, SINGLE_TAP = 0b001, DOUBLE_TAP = 0b010, LONG_PRESS = 0b100};
+struct pbOpCounts {
+  uint32_t updates;       // calls to update()
+  uint32_t pinReads;      // digitalReadFast() calls
+  uint32_t clockReads;    // millis() reads
+  uint32_t transitions;   // state changes
+  uint32_t lockoutSkips;  // calls to update() that skipped the pin read due to debounce lockout
+};
+
+  /* Dynamic state of a pushbutton, for checkpoint/restore (see pushButtonClass::saveState()). Configuration set by init() 
+      and setDelays() is not included.
+  */
+struct pbButtonState {
+  uint32_t lockoutStart;  // start time (ms) of debounce lockout period
+  uint32_t delayStart;    // start time (ms) of double-tap and longpress delays
+  uint8_t state;          // stateEnum
+  uint8_t event;          // eventEnum
+  bool lockout;
+  bool buttonActive;
+};
+
+#ifdef PB_INSTRUMENT
+extern pbOpCounts pbTotalOps;   // counts totalled over all pushbuttons
+#define PB_COUNT(field) do { ops.field++; pbTotalOps.field++; } while (0)
+#else
+#define PB_COUNT(field) do { } while (0)
+#endif
 
 
 class pushButtonClass {
   uint8_t activeLevel;  // logic level for button press (HIGH or LOW)
   stateEnum state;      // current state of the switch (see swStateEnum)
   eventEnum event;      // last switch event detected
-  elapsedMillis delayTimer;   // timer used for double-tap and longpress delays
-  elapsedMillis lockoutTimer; // timer used for pushbitton switch debouncing
+  uint32_t delayStart;    // start time (ms) of double-tap and longpress delays
+  uint32_t lockoutStart;  // start time (ms) of pushbutton switch debounce lockout period
+  uint32_t pinMask;       // bit mask of the pin in its GPIO port
+  uint32_t activeSample;  // value of (port sample & pinMask) when the button is pressed
   uint16_t debouncePeriod = defDebouncePeriod; // pushbutton switch debounce lockout period (ms)
   uint16_t doubleTapDelay = defDoubleTapDelay; // max delay between first and second press (ms)
   uint16_t longPressDuration = defLongPressDur; // min duration of long press (ms)
@@ -39,16 +94,64 @@ class pushButtonClass {
   bool lockout; // true when switch is in debounce lockout period
   bool doubleTapEnabled;  // true if double-tap function has been enabled
   bool longPressEnabled;  // true when long-press function has been enabled
+#ifdef PB_DOUBLE_TAP_HOLD
+  bool doubleTapHoldEnabled;  // true when double-tap-and-hold function has been enabled
+#endif
+  pushButtonRingClass *ring;  // event ring to publish events to (NULL if none)
+#ifdef PB_INSTRUMENT
+  pbOpCounts ops;     // operation counts for this pushbutton
+#endif
+#ifdef PB_EDGE_CAPTURE
+  volatile uint32_t edgeTime[edgeFifoSize];  // timestamps (us) of captured edges
+  volatile uint8_t edgeLevels;  // bit n is the pin level after edge n
+  volatile uint8_t edgeHead;    // number of edges captured (mod 256)
+  uint8_t edgeTail;       // number of edges processed (mod 256)
+  bool edgeActive;        // pushbutton state after the last processed edge
+  uint32_t pressTime;     // timestamp (us) of the edge that started the last accepted press
+  uint32_t levelTime;     // timestamp (us) of the edge that set edgeActive
+  uint32_t evalTime;      // time (ms) of the last run of the state machine by updateEdges()
+#endif
+  void setEvent(eventEnum ev, uint32_t now);
+  bool inLockout(uint32_t now);
+  void runState(bool active, uint32_t now);
+#ifdef PB_EDGE_CAPTURE
+  void runEdge(bool active, uint32_t now, uint32_t timeUs);
+  bool stepEdge(uint32_t now);
+#endif
 public:
   uint8_t pNum;       // pin number of pushbutton switch input
   void init(uint8_t ioPinNum, uint8_t actLevel, bool pullup, int eventSel);
   void setDelays(uint16_t dbPeriod, uint16_t doubleDly, uint16_t longDur);
+  void getDelays(uint16_t &dbPeriod, uint16_t &doubleDly, uint16_t &longDur);
+  void setSampleMask(uint32_t mask);
+  void attachRing(pushButtonRingClass *evRing);
   void update();
+  void updateSample(uint32_t sample, uint32_t now);
+  void updateBlock(const uint32_t *samples, uint16_t count, uint16_t samplePeriod);
+  void updateBlock(const uint32_t *samples, uint16_t count, uint16_t samplePeriod, uint32_t lastTime);
+  bool nextDeadline(uint32_t now, uint32_t &deadline);
+  stateEnum getState();
+  bool lockedOut();
+  uint8_t holdProgress(uint32_t now);
+  void saveState(pbButtonState &st);
+  void restoreState(const pbButtonState &st);
+#ifdef PB_EDGE_CAPTURE
+  void captureEdge(uint8_t level, uint32_t timeUs);
+  void updateEdges();
+  uint32_t pressMicros();
+#endif
   bool singleTap();
   bool doubleTap();
   bool longPress();
+#ifdef PB_DOUBLE_TAP_HOLD
+  bool doubleTapHold();
+#endif
   bool eventDetected();
   eventEnum getEvent();
+#ifdef PB_INSTRUMENT
+  void getOpCounts(pbOpCounts &snap);
+  void resetOpCounts();
+#endif
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,33 @@
+#include <Arduino.h>
+#include "Pushbutton.h"
+
+#ifndef _PB_BANK_TYPES
+#define _PB_BANK_TYPES
+
+class pushButtonFeedbackClass;   // see PushbuttonFeedback.h
+
+  /* A bank is a group of pushbuttons that are updated together. When all of the pushbuttons are connected to the same GPIO
+      port, the port is read once per update for all of them, and one millis() value is shared.
+  */
+class pushButtonBankClass {
+  pushButtonClass *buttons;     // array of pushbuttons in the bank
+  uint8_t numButtons;           // number of elements in buttons[]
+  volatile uint32_t *portIn;    // GPIO port input register shared by all pushbuttons (NULL if they are on different ports)
+  uint32_t portMask;            // bit mask of all pushbutton pins in the port
+  pushButtonFeedbackClass *feedback;  // feedback outputs driven at the end of each update (NULL if none)
+public:
+  void init(pushButtonClass *btns, uint8_t count);
+  void setCount(uint8_t count);
+  void attachFeedback(pushButtonFeedbackClass *fb);
+  void update();
+  void updateBlock(const uint32_t *samples, uint16_t count, uint16_t samplePeriod);
+  void updateBlock(const uint32_t *samples, uint16_t count, uint16_t samplePeriod, uint32_t lastTime);
+  void saveState(pbButtonState *states);
+  void restoreState(const pbButtonState *states);
+  uint8_t getCount();
+  pushButtonClass *getButton(uint8_t index);
+  volatile uint32_t *getPort();
+  uint32_t getPortMask();
+};
+
+#endif
@@ -0,0 +1,46 @@
+#include <Arduino.h>
+#include "Pushbutton.h"
+
+#ifndef _PB_CAL_TYPES
+#define _PB_CAL_TYPES
+
+  // Calibration store layout; the store occupies calNumSlots * sizeof(pbCalRecord) bytes starting at the base address
+const uint8_t calMaxButtons = 8;   // max number of buttons in one calibration record
+const uint8_t calNumSlots = 8;     // number of EEPROM slots used for wear levelling
+const uint16_t calEmuSize = 1080;  // size of the emulated EEPROM (bytes), used when PB_CAL_EMULATE_EEPROM is defined
+
+  /* Timing values for one pushbutton (see pushButtonClass::setDelays()) */
+struct pbCalEntry {
+  uint16_t debouncePeriod;
+  uint16_t doubleTapDelay;
+  uint16_t longPressDuration;
+};
+
+  /* Calibration record for a group of pushbuttons. Each save() writes the record to the next slot with an incremented
+      sequence number, so writes are spread evenly over all slots. The valid slot with the newest sequence number is current.
+  */
+struct pbCalRecord {
+  uint16_t seq;         // sequence number, incremented on each save
+  uint8_t numButtons;   // number of valid entries
+  uint8_t reserved;
+  pbCalEntry entry[calMaxButtons];
+  uint16_t crc;         // CRC-16/CCITT of all preceding bytes
+};
+
+
+class pushButtonCalClass {
+  uint16_t baseAddr;    // EEPROM address of the first slot
+  uint8_t curSlot;      // slot holding the current record
+  bool curValid;        // true if a valid record was found by the last load() or written by save()
+  pbCalRecord rec;      // copy of the current record
+  void readBytes(uint16_t addr, uint8_t *dst, uint16_t len);
+  void writeBytes(uint16_t addr, const uint8_t *src, uint16_t len);
+  uint16_t calcCrc(const pbCalRecord &r);
+  bool findCurrent();
+public:
+  void init(uint16_t eepromAddr);
+  bool load(pushButtonClass *buttons, uint8_t numButtons);
+  bool save(pushButtonClass *buttons, uint8_t numButtons);
+};
+
+#endif
@@ -0,0 +1,41 @@
+#include <Arduino.h>
+#include "Pushbutton.h"
+
+#ifndef _PB_CAPTURE_TYPES
+#define _PB_CAPTURE_TYPES
+
+const uint8_t captureMaxButtons = 4;  // max number of pushbuttons routed to edge capture
+const uint8_t capturePrescale = 7;    // QuadTimer clock: IP bus clock (F_BUS_ACTUAL) / 2^capturePrescale (128)
+
+  /* Routes pushbutton inputs to QuadTimer input-capture channels (Teensy 4.x), so that each edge is timestamped by the
+      timer hardware when it occurs and queued with pushButtonClass::captureEdge(). Requires PB_EDGE_CAPTURE; the
+      pushbuttons must then be updated with updateEdges() instead of update().
+    Only pins connected to a QuadTimer input can be used (Teensy 4.0: 10, 11, 12, 13, 14, 15, 18, 19); their timer
+      channels must not be used for PWM (analogWrite()) at the same time. The capture register holds the counter value of
+      the edge, and the interrupt that passes it on converts it to the micros() time base, so interrupt latency (up to one
+      counter period, 55.9 ms with the 150 MHz bus clock) doesn't affect the timestamp. The tick length is taken from
+      F_BUS_ACTUAL by attach(); call setBusClock() after changing the CPU speed (e.g. with set_arm_clock()).
+    When PB_MOCK_CAPTURE is defined, no timers are used and edges are injected with mockEdge() (e.g. for host testing).
+  */
+class pushButtonCaptureClass {
+  static pushButtonClass *slotButton[captureMaxButtons];  // pushbutton assigned to each capture slot (NULL if free)
+  static uint32_t tickScale;  // length of a QuadTimer tick (us, 16.16 fixed point)
+#ifndef PB_MOCK_CAPTURE
+  static uint8_t slotInput[captureMaxButtons];  // QuadTimer input of each slot (index in captureInputs[])
+  static void service(uint8_t module);
+  static void isrTmr1();
+  static void isrTmr2();
+  static void isrTmr3();
+#endif
+public:
+  static int8_t attach(pushButtonClass *btn);
+  static void detach(pushButtonClass *btn);
+  static void relocate(pushButtonClass *from, pushButtonClass *to);
+  static void setBusClock(uint32_t busHz);
+  static uint32_t edgeMicros(uint16_t captured, uint16_t counter, uint32_t nowUs);
+#ifdef PB_MOCK_CAPTURE
+  static void mockEdge(uint8_t slot, uint8_t level, uint32_t timeUs);
+#endif
+};
+
+#endif
@@ -0,0 +1,62 @@
+#include <Arduino.h>
+#include "PushbuttonBank.h"
+
+#ifndef _PB_FEEDBACK_TYPES
+#define _PB_FEEDBACK_TYPES
+
+const uint8_t fbMaxOutputs = 16;    // max number of feedback outputs (one per pushbutton in the bank)
+const uint16_t fbBlinkPeriod = 200; // period of FB_BLINK pattern (ms)
+const uint8_t fbPwmPeriod = 16;     // period of software PWM used by FB_RAMP (ms)
+
+  /* Feedback output patterns:
+      FB_OFF: Output off
+      FB_ON: Output on
+      FB_BLINK: Output blinks (fbBlinkPeriod)
+      FB_RAMP: Output duty cycle follows long-press progress (see pushButtonClass::holdProgress()), from 1/fbPwmPeriod to
+        fully on
+    Blink and PWM cycles start (with the output on) when the pattern is entered, so there is no added latency.
+  */
+enum fbPatternEnum {FB_OFF, FB_ON, FB_BLINK, FB_RAMP};
+
+  /* Feedback output backends:
+      FB_PORT: Outputs are pins on one GPIO port, written together with the port's set/clear registers
+      FB_CALLBACK: Outputs are bits of a word passed to a user function (e.g. to start a DMA transfer to a shift-register
+        chain); called only when the word changes
+      FB_MOCK: Outputs are only recorded, with the time of each change (only when compiled with PB_MOCK_FEEDBACK)
+  */
+enum fbBackendEnum {FB_PORT, FB_CALLBACK, FB_MOCK};
+
+
+  /* Drives one output (e.g. an LED or haptic driver) per pushbutton of a bank, from the pushbutton state, at the end of 
+      the same scan that updated the state (see pushButtonBankClass::attachFeedback()). The pattern shown for each state
+      can be changed with setPattern(). Outputs are written only when they change.
+  */
+class pushButtonFeedbackClass {
+  fbBackendEnum backend;
+  void (*writeFn)(uint32_t bits);  // output function for FB_CALLBACK
+  volatile uint32_t *setReg;    // port set register for FB_PORT
+  volatile uint32_t *clearReg;  // port clear register for FB_PORT
+  uint32_t outMask[fbMaxOutputs]; // output bit of each pushbutton (0 if none)
+  uint32_t allMask;   // all output bits
+  uint32_t lastBits;  // output bits last written
+  uint8_t pattern[WAIT_DOUBLE_HOLD + 1];  // pattern shown for each stateEnum
+  uint8_t curPattern[fbMaxOutputs];   // pattern currently shown by each output
+  uint32_t patternStart[fbMaxOutputs];  // time (ms) when each output entered its current pattern
+#ifdef PB_MOCK_FEEDBACK
+  uint32_t mockChange[fbMaxOutputs];  // time of the last change of each output (ms)
+#endif
+  void updateAllMask();
+public:
+  void init(fbBackendEnum be, void (*fn)(uint32_t bits));
+  void setOutput(uint8_t index, uint8_t outPin);
+  void clearOutput(uint8_t index);
+  void moveOutput(uint8_t from, uint8_t to);
+  void setPattern(stateEnum st, fbPatternEnum pat);
+  void apply(pushButtonBankClass *bank, uint32_t now);
+#ifdef PB_MOCK_FEEDBACK
+  uint32_t mockLastChange(uint8_t index);
+  uint32_t mockBits();
+#endif
+};
+
+#endif
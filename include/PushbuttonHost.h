@@ -0,0 +1,30 @@
+#include <Arduino.h>
+#include "PushbuttonRing.h"
+
+#ifndef _PB_HOST_TYPES
+#define _PB_HOST_TYPES
+
+#ifdef PB_HOST_API
+
+const uint8_t hostMaxButtons = 8;   // max number of pushbuttons per pbHostRun() call
+
+  /* C interface to the pushbutton engine for host builds (e.g. a shared library loaded from Python with ctypes). All 
+      arrays are passed by pointer and used in place, so NumPy arrays can be passed without copying, e.g.:
+        samples: np.ascontiguousarray(s, dtype=np.uint32); pass s.ctypes.data_as(POINTER(c_uint32))
+        events:  np.zeros(n, dtype=np.dtype({'names': ['time', 'pin', 'event', 'count'],
+                                             'formats': ['<u4', 'u1', '<i4', 'u1'],
+                                             'offsets': [0, 4, 8, 12], 'itemsize': 16}))
+      The events dtype matches pbEventRecord (checked at compile time in PushbuttonHost.cpp). test/host/pbhost.py wraps
+      the library built by test/CMakeLists.txt (libpbhost).
+  */
+extern "C" {
+  uint32_t pbHostRun(const uint32_t *samples, const uint32_t *times, uint32_t count, 
+    const uint8_t *pins, uint8_t numPins, uint8_t actLevel, int eventSel, 
+    uint16_t dbPeriod, uint16_t doubleDly, uint16_t longDur, 
+    pbEventRecord *events, uint32_t maxEvents);
+  uint32_t pbHostEventSize();
+}
+
+#endif
+
+#endif
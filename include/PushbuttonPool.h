@@ -0,0 +1,50 @@
+#include <Arduino.h>
+#include "PushbuttonBank.h"
+#include "PushbuttonFeedback.h"
+#ifdef PB_EDGE_CAPTURE
+#include "PushbuttonCapture.h"
+#endif
+
+#ifndef _PB_POOL_TYPES
+#define _PB_POOL_TYPES
+
+const uint8_t poolSize = 16;    // max number of pushbuttons in the pool
+
+  /* Fixed-size pool of pushbuttons that can be added and removed at runtime, in groups (modules), without heap allocation.
+      Active pushbuttons are always kept packed at the start of the pool, so that update() iterates over a dense array. 
+      Each pushbutton is identified by a handle that stays valid until it is removed; since pushbuttons move within the 
+      pool when others are removed, pointers returned by get() are only valid until the next remove().
+    Registries that refer to pool pushbuttons by address or bank index are kept in step by add() and remove():
+      - The bank returned by getBank() is resized, so that a pointer kept to it (e.g. by the sampler or the simulator)
+        always scans exactly the active pushbuttons.
+      - Feedback outputs must be attached and assigned through the pool (attachFeedback(), setOutput() by handle); the
+        output of a moved pushbutton follows it to its new bank index, and the output of a removed one is turned off.
+      - Edge capture slots (pushButtonCaptureClass, PB_EDGE_CAPTURE) are passed to the moved pushbutton, and the slot of
+        a removed pushbutton is freed.
+    A removed pushbutton is also detached from its event ring, and its pin is returned to INPUT (no pullup). Other
+      references to pool pushbuttons (e.g. a bank initialized directly on get() pointers) are not updated.
+  */
+class pushButtonPoolClass {
+  pushButtonClass buttons[poolSize];  // active pushbuttons are buttons[0] to buttons[numActive - 1]
+  uint8_t moduleOf[poolSize];   // module number of each active pushbutton (parallel to buttons[])
+  uint8_t handleOf[poolSize];   // handle of each active pushbutton (parallel to buttons[])
+  uint8_t slotOf[poolSize];     // index in buttons[] of each handle
+  uint8_t freeHandles[poolSize];  // stack of unused handles
+  uint8_t numFree;      // number of elements in freeHandles[]
+  uint8_t numActive;    // number of active pushbuttons
+  pushButtonBankClass bank;   // bank view of the active pushbuttons (see getBank()), resized by add() and remove()
+  pushButtonFeedbackClass *feedback;  // feedback outputs of the active pushbuttons, by slot (NULL if none)
+public:
+  void init();
+  int8_t add(uint8_t module, uint8_t ioPinNum, uint8_t actLevel, bool pullup, int eventSel);
+  void remove(uint8_t handle);
+  uint8_t removeModule(uint8_t module);
+  pushButtonClass *get(uint8_t handle);
+  void attachFeedback(pushButtonFeedbackClass *fb);
+  void setOutput(uint8_t handle, uint8_t outPin);
+  uint8_t getCount();
+  pushButtonBankClass *getBank();
+  void update();
+};
+
+#endif
@@ -0,0 +1,51 @@
+#include <Arduino.h>
+#include "Pushbutton.h"
+
+#ifndef _PB_RING_TYPES
+#define _PB_RING_TYPES
+
+const uint8_t ringSize = 16;     // number of events held by the ring (must be a power of 2)
+const uint8_t ringMaxSubs = 4;   // max number of subscribers (consumers)
+
+  /* Event published to the ring */
+struct pbEventRecord {
+  uint32_t time;    // millis() when the event was detected
+  uint8_t pin;      // pin number of the pushbutton (see pushButtonClass::pNum)
+  eventEnum event;  // detected event
+  uint8_t count;    // number of identical events merged into this record by coalescing (normally 1)
+};
+
+
+  /* Broadcast event ring. One producer (one or more pushbuttons, via pushButtonClass::attachRing()) publishes events, and
+      each subscriber reads every event through its own cursor. The producer never waits: a subscriber that falls more than
+      ringSize events behind skips the oldest events, which are counted as overruns.
+    Events are in time order when the pushbuttons sharing a ring are updated together, one sample or time step for all of
+      them at a time (pushButtonBankClass::update() and updateBlock(), pushButtonPoolClass::update()). Pushbuttons updated
+      separately (e.g. each with its own pushButtonClass::updateBlock() call) publish each pin's events in time order only.
+    When coalescing is enabled and the slowest subscriber has a backlog, an event identical to the newest event from the 
+      same pushbutton is merged into it by incrementing its count, instead of taking a new slot. This is only done while no
+      subscriber has read the newest event, so a record's count never changes after any subscriber has read it.
+  */
+class pushButtonRingClass {
+  pbEventRecord buf[ringSize];  // event storage
+  uint32_t head;                // total number of events published
+  uint32_t cursor[ringMaxSubs]; // number of events read by each subscriber
+  uint32_t overrunCount[ringMaxSubs];   // number of events missed by each subscriber
+  uint8_t numSubs;              // number of subscribers
+  uint8_t coalesceThreshold;    // min backlog (events) of the slowest subscriber to enable coalescing; 0 = disabled
+  uint32_t publishedCount;      // number of events published (including coalesced events)
+  uint32_t coalescedCount;      // number of events merged into a previous record
+  void getBacklog(uint32_t &minLag, uint32_t &maxLag);
+public:
+  void init();
+  int8_t subscribe();
+  void publish(uint8_t pin, eventEnum ev, uint32_t time);
+  const pbEventRecord *read(uint8_t sub);
+  uint8_t available(uint8_t sub);
+  uint32_t overruns(uint8_t sub);
+  void setCoalescing(uint8_t threshold);
+  uint32_t published();
+  uint32_t coalesced();
+};
+
+#endif
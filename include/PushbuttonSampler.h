@@ -0,0 +1,47 @@
+#include <Arduino.h>
+#include "PushbuttonBank.h"
+#ifndef PB_MOCK_SAMPLER
+#include <DMAChannel.h>
+#endif
+
+#ifndef _PB_SAMPLER_TYPES
+#define _PB_SAMPLER_TYPES
+
+const uint16_t samplerHalfSize = 32;  // number of port samples in each half of the ping-pong buffer
+
+  /* Samples the GPIO port of a pushbutton bank at a fixed rate, without CPU involvement: a PIT timer triggers a DMA transfer
+      of the port input register into a ping-pong buffer. poll() passes each completed half-buffer to the bank's 
+      updateBlock(). The PIT channel with the same number as the DMA channel (0-3) is used, so it must not be used by an 
+      IntervalTimer. Declare the sampler as a global (not DMAMEM), so that the buffer is in DTCM and needs no cache 
+      maintenance.
+    When PB_MOCK_SAMPLER is defined, the timer and DMA are replaced by mockTrigger() (e.g. for host testing).
+  */
+class pushButtonSamplerClass {
+  uint32_t buf[2 * samplerHalfSize];  // ping-pong buffer of port samples
+  volatile uint8_t readyMask;   // bit n is set when half n has been filled and not yet processed
+  volatile uint32_t halfTime[2];  // millis() when each half was completed
+  volatile uint32_t overrunCount; // number of halves overwritten before being processed
+  uint8_t fillHalf;     // half currently being filled
+  uint8_t pollHalf;     // next half to be processed by poll()
+  uint16_t samplePeriod;    // interval between samples (ms)
+  pushButtonBankClass *bank;  // bank that processes the samples
+  void completeHalf(uint32_t now);
+#ifdef PB_MOCK_SAMPLER
+  uint16_t mockIndex;   // next buffer element written by mockTrigger()
+#else
+  DMAChannel dma;       // DMA channel that copies the port register to buf
+  uint8_t pitChannel;   // PIT channel that triggers the DMA channel
+  static pushButtonSamplerClass *activeSampler;   // sampler serviced by isr()
+  static void isr();
+#endif
+public:
+  bool begin(pushButtonBankClass *bnk, uint16_t periodMs);
+  void end();
+  uint8_t poll();
+  uint32_t overruns();
+#ifdef PB_MOCK_SAMPLER
+  void mockTrigger(uint32_t portValue, uint32_t now);
+#endif
+};
+
+#endif
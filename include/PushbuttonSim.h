@@ -0,0 +1,62 @@
+#include <Arduino.h>
+#include "PushbuttonBank.h"
+#include "PushbuttonRing.h"
+
+#ifndef _PB_SIM_TYPES
+#define _PB_SIM_TYPES
+
+const uint8_t simMaxButtons = 8;  // max number of pushbuttons in a checkpointed bank
+
+  /* Complete simulation state at one point in time, for checkpoint/restore */
+struct pbSimCheckpoint {
+  uint32_t simTime;   // time of the next update (ms)
+  uint32_t nextEdge;  // index of next trace edge to apply
+  uint32_t sample;    // port value
+  bool idle;
+  pbButtonState button[simMaxButtons];   // state of each pushbutton in the bank
+};
+
+  /* Input trace edge: from "time" onwards, the sampled GPIO port has the value "sample" */
+struct pbTraceEdge {
+  uint32_t time;    // time of the edge (ms)
+  uint32_t sample;  // port value after the edge
+};
+
+
+  /* Discrete-event simulator that replays an input trace through a pushbutton bank. Instead of updating every millisecond,
+      the virtual clock jumps straight to the next input edge or the next lockout/delay deadline (see 
+      pushButtonClass::nextDeadline()), producing the same events as a fixed-tick replay with far fewer updates. Events are
+      consumed from the pushbuttons (as with getEvent()) and returned as pbEventRecords.
+    If a checkpoint buffer is provided, run() saves a checkpoint at regular intervals of simulated time. seek() then 
+      restores the last checkpoint before a given time, so that a window near the end of a long trace (e.g. where a gesture
+      was misclassified) can be replayed without starting over. When the buffer is full, every other checkpoint is dropped
+      and the interval is doubled.
+  */
+class pushButtonSimClass {
+  pushButtonBankClass *bank;  // simulated bank
+  const pbTraceEdge *trace;   // input edges, in time order
+  uint32_t traceLen;          // number of elements in trace[]
+  uint32_t nextEdge;          // index of next edge to apply
+  uint32_t sample;            // current port value
+  uint32_t simTime;           // time of the next update (ms)
+  bool idle;                  // true if nothing can happen until the next edge
+  uint32_t stepCount;         // number of bank updates performed
+  pbSimCheckpoint *ckpt;      // checkpoint buffer (NULL if none)
+  uint16_t ckptSize;          // number of elements in ckpt[]
+  uint16_t numCkpts;          // number of checkpoints saved
+  uint32_t ckptInterval;      // simulated time between checkpoints (ms)
+  uint32_t nextCkptTime;      // time of the next checkpoint (ms)
+  void saveCheckpoint();
+  bool step(pbEventRecord *events, uint32_t maxEvents, uint32_t &numEvents);
+  void applyEdges();
+public:
+  void init(pushButtonBankClass *bnk, const pbTraceEdge *edges, uint32_t numEdges, uint32_t initialSample);
+  uint32_t run(uint32_t endTime, pbEventRecord *events, uint32_t maxEvents);
+  uint32_t runFixedTick(uint32_t endTime, pbEventRecord *events, uint32_t maxEvents);
+  bool setCheckpoints(pbSimCheckpoint *buf, uint16_t count, uint32_t interval);
+  bool seek(uint32_t t);
+  uint32_t time();
+  uint32_t steps();
+};
+
+#endif
@@ -0,0 +1,98 @@
+# Post-build check (PlatformIO extra script) that the pushbutton scan path was placed in ITCM and that cold configuration
+#   code was left in flash (see PB_FASTRUN / PB_FLASHMEM in Pushbutton.h). Global objects listed in the
+#   custom_pb_dtcm_objects option of platformio.ini are checked to be in DTCM. Functions that the linker discarded
+#   (unused, or compiled out with the PB_* feature macros) are skipped, except for the REQUIRED ones, which the example
+#   in src/_main.cpp links. The build fails if anything is misplaced, or if a REQUIRED function or listed object is
+#   missing (e.g. because nothing uses it, so that the check would pass without checking anything).
+
+Import("env")
+
+import subprocess
+
+ITCM = (0x00000000, 0x00080000)
+DTCM = (0x20000000, 0x20080000)
+FLASH = (0x60000000, 0x61000000)
+
+HOT = [
+    "pushButtonClass::update()",
+    "pushButtonClass::updateSample(",
+    "pushButtonClass::updateBlock(",
+    "pushButtonClass::inLockout(",
+    "pushButtonClass::runState(",
+    "pushButtonClass::setEvent(",
+    "pushButtonClass::nextDeadline(",
+    "pushButtonClass::holdProgress(",
+    "pushButtonClass::captureEdge(",
+    "pushButtonClass::updateEdges(",
+    "pushButtonClass::runEdge(",
+    "pushButtonClass::stepEdge(",
+    "pushButtonBankClass::update()",
+    "pushButtonBankClass::updateBlock(",
+    "pushButtonPoolClass::update()",
+    "pushButtonRingClass::publish(",
+    "pushButtonSamplerClass::poll(",
+    "pushButtonSamplerClass::isr(",
+    "pushButtonSamplerClass::completeHalf(",
+    "pushButtonCaptureClass::service(",
+    "pushButtonCaptureClass::isrTmr",
+    "pushButtonCaptureClass::edgeMicros(",
+    "pushButtonFeedbackClass::apply(",
+]
+COLD = [
+    "pushButtonClass::init(",
+    "pushButtonClass::setDelays(",
+    "pushButtonBankClass::init(",
+    "pushButtonCalClass::",
+]
+REQUIRED = [
+    "pushButtonClass::update()",
+    "pushButtonClass::init(",
+]
+
+
+def in_range(addr, rng):
+    return rng[0] <= addr < rng[1]
+
+
+def check_placement(source, target, env):
+    elf = str(target[0])
+    nm = env.subst("$CC").replace("gcc", "nm")
+    out = subprocess.run([nm, "-C", "--defined-only", elf], capture_output=True, text=True, check=True).stdout
+    objects = env.GetProjectOption("custom_pb_dtcm_objects", "").split()
+    errors = []
+    checked = 0
+    found = set()
+    for line in out.splitlines():
+        parts = line.split(" ", 2)
+        if (len(parts) < 3) or (len(parts[1]) != 1):
+            continue
+        try:
+            addr = int(parts[0], 16) & ~1   # clear Thumb bit
+        except ValueError:
+            continue
+        name = parts[2]
+        found.update(r for r in REQUIRED if (parts[1] in "tT") and name.startswith(r))
+        found.update(o for o in objects if name == o)
+        if any(name.startswith(h) for h in HOT) and parts[1] in "tT":
+            checked += 1
+            if not in_range(addr, ITCM):
+                errors.append("%s at 0x%08x is not in ITCM" % (name, addr))
+        elif any(name.startswith(c) for c in COLD) and parts[1] in "tT":
+            checked += 1
+            if not in_range(addr, FLASH):
+                errors.append("%s at 0x%08x is not in flash" % (name, addr))
+        elif name in objects:
+            checked += 1
+            if not in_range(addr, DTCM):
+                errors.append("%s at 0x%08x is not in DTCM" % (name, addr))
+    for r in REQUIRED + objects:
+        if r not in found:
+            errors.append("%s not found in %s" % (r, elf))
+    for e in errors:
+        print("check_placement: " + e)
+    if errors:
+        env.Exit(1)
+    print("check_placement: %d symbols correctly placed" % checked)
+
+
+env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", check_placement)
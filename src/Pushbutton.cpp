@@ -4,10 +4,17 @@
       SINGLE_TAP: Button is pressed briefly, one time
       DOUBLE_TAP: Button is pressed twice in quick succession
       LONG_PRESS: Button is pressed and held for a minimumn duration
+      DOUBLE_TAP_HOLD: Button is tapped, then pressed again and held for the long-press duration (when compiled with
+        PB_DOUBLE_TAP_HOLD defined)
 */
 
 #include <Arduino.h>
 #include "Pushbutton.h"
+#include "PushbuttonRing.h"
+
+#ifdef PB_INSTRUMENT
+pbOpCounts pbTotalOps;  // operation counts totalled over all pushbuttons
+#endif
 
 
 /* pushButtonClass::init()
@@ -19,15 +26,34 @@
       int eventSel: bit mask used to enable events in additon to SINGLE_TAP (see eventEnum in Pushbutton.h)
     Returns: None
 */
-void pushButtonClass::init(uint8_t ioPinNum, uint8_t actLevel, bool pullup, int eventSel) {
+PB_FLASHMEM void pushButtonClass::init(uint8_t ioPinNum, uint8_t actLevel, bool pullup, int eventSel) {
   pNum = ioPinNum;
   activeLevel = actLevel;
   pinMode(pNum, (pullup? INPUT_PULLUP: INPUT)); // configure the input pin
   state = RDY; 
   event = NO_PRESS;
   lockout = false;
-  doubleTapEnabled = (eventSel & DOUBLE_TAP);
+  pinMask = digitalPinToBitMask(pNum);
+  activeSample = ((activeLevel == HIGH) ? pinMask : 0);
+  ring = NULL;
   longPressEnabled = (eventSel & LONG_PRESS);
+#ifdef PB_DOUBLE_TAP_HOLD
+  doubleTapHoldEnabled = (eventSel & DOUBLE_TAP_HOLD);
+  doubleTapEnabled = (eventSel & (DOUBLE_TAP | DOUBLE_TAP_HOLD));  // double-tap-and-hold starts with a double-tap
+#else
+  doubleTapEnabled = (eventSel & DOUBLE_TAP);
+#endif
+#ifdef PB_INSTRUMENT
+  resetOpCounts();
+#endif
+#ifdef PB_EDGE_CAPTURE
+  edgeHead = 0;
+  edgeTail = 0;
+  edgeActive = (digitalReadFast(pNum) == activeLevel);
+  pressTime = 0;
+  levelTime = 0;
+  evalTime = millis();
+#endif
 }
 
 
@@ -39,7 +65,7 @@ void pushButtonClass::init(uint8_t ioPinNum, uint8_t actLevel, bool pullup, int
       uint16_t doubleDly: Max delay between first and second press (ms)
       uint16_t longDur: Min duration of long press (ms)
 */
-void pushButtonClass::setDelays(uint16_t dbPeriod, uint16_t doubleDly, uint16_t longDur) {
+PB_FLASHMEM void pushButtonClass::setDelays(uint16_t dbPeriod, uint16_t doubleDly, uint16_t longDur) {
   if (dbPeriod > 0)
     debouncePeriod = dbPeriod;
   if (doubleDly > 0)
@@ -49,76 +75,476 @@ void pushButtonClass::setDelays(uint16_t dbPeriod, uint16_t doubleDly, uint16_t
 }
 
 
+/* pushButtonClass::setSampleMask()
+    Overrides the bit mask used to find the pushbutton's level in the samples passed to updateSample() and updateBlock(),
+      which init() derives from the pin number with digitalPinToBitMask(). Used when samples don't come from the
+      pushbutton's GPIO port, e.g. recorded captures on a host.
+    Parameters:
+      uint32_t mask: bit mask of the pushbutton's level in the samples
+    Returns: None
+*/
+PB_FLASHMEM void pushButtonClass::setSampleMask(uint32_t mask) {
+  pinMask = mask;
+  activeSample = ((activeLevel == HIGH) ? pinMask : 0);
+}
+
+
+/* pushButtonClass::getDelays()
+    Returns the timing values currently used for switch debouncing and event detection (e.g. to save them with 
+      pushButtonCalClass).
+    Parameters:
+      uint16_t &dbPeriod: Receives the pushbutton switch debounce lockout period (ms)
+      uint16_t &doubleDly: Receives the max delay between first and second press (ms)
+      uint16_t &longDur: Receives the min duration of long press (ms)
+*/
+PB_FLASHMEM void pushButtonClass::getDelays(uint16_t &dbPeriod, uint16_t &doubleDly, uint16_t &longDur) {
+  dbPeriod = debouncePeriod;
+  doubleDly = doubleTapDelay;
+  longDur = longPressDuration;
+}
+
+
+/* pushButtonClass::attachRing()
+    Attaches an event ring (see PushbuttonRing.h). Every event detected by update() is then also published to the ring, so
+      that it can be seen by multiple consumers. Events can still be read with singleTap(), getEvent(), etc.
+    Parameters:
+      pushButtonRingClass *evRing: event ring, previously initialized with init(); NULL to detach
+    Returns: None
+*/
+PB_FLASHMEM void pushButtonClass::attachRing(pushButtonRingClass *evRing) {
+  ring = evRing;
+}
+
+
+/* pushButtonClass::setEvent()
+    Records a newly detected event and publishes it to the attached event ring, if any.
+    Parameters:
+      eventEnum ev: detected event
+      uint32_t now: time of the event (ms)
+    Returns: None
+*/
+PB_FASTRUN void pushButtonClass::setEvent(eventEnum ev, uint32_t now) {
+  event = ev;
+  if (ring != NULL)
+    ring->publish(pNum, ev, now);
+}
+
+
 /* pushButtonClass::update()
     Called periodically to monitor a pushbutton switch and detect one of the possible events defined by eventEnum (in Pushbutton.h). 
     The interval between calls should be less than the debounce period (80ms by default)
 */
-void pushButtonClass::update() {
-  if (lockout) {   // if pushbutton is currently in debounce lockout period
-    if (lockoutTimer > debouncePeriod)  // if debounce period expired
-      lockout = false;   // end lockout, handle other actions in next call to update()
+PB_FASTRUN void pushButtonClass::update() {
+  uint32_t now;
+
+  PB_COUNT(updates);
+  PB_COUNT(clockReads);
+  now = millis();   // single clock read, shared by all timing checks in this call
+  if (!inLockout(now)) {
+    PB_COUNT(pinReads);
+    runState((digitalReadFast(pNum) == activeLevel), now);  // get current pushbutton state (active or not)
   }
-  else {  // not in debounce lockout period
-    buttonActive = (digitalReadFast(pNum) == activeLevel);  // get current pushbutton state (active or not)
-    switch (state) {   // actions depend on current state
-      case RDY:   // waiting for switch press
-        if (buttonActive) {  // button was pressed
-          lockout = true;  // start lockout period
-          lockoutTimer = 0;  // start lockout period
-          delayTimer = 0;  // start delay timer for other possible actions
-          if (doubleTapEnabled || longPressEnabled)   // if either of these functions are enabled
-            state = WAIT_LONG;   // transition to the next state, used by both functions
-          else {  // neither function is enabled
-            event = SINGLE_TAP;  // record the press event immediately (no delays to wait for possible long- or double-)
-            state = WAIT_INACTIVE;   // go to this state to wait for switch release
-          }
-        } 
-      break;
-      case WAIT_LONG:   // button was pressed and either double-tap or long-press functions are enabled
-        if (buttonActive) {  // if switch is still active (not yet released)
-          if (longPressEnabled) {
-            if (delayTimer > longPressDuration) {   // if long-press delay has expired
-              event = LONG_PRESS;  // record the event
-              state = WAIT_INACTIVE;   // go to this state to wait for button release
-            }
-          }
+}
+
+
+/* pushButtonClass::updateSample()
+    Same as update(), but uses a previously captured sample of the pushbutton's GPIO port instead of reading the pin, and a
+      caller-supplied time instead of millis(). Used by updateBlock() and pushButtonBankClass, and for replaying recorded
+      samples.
+    Parameters:
+      uint32_t sample: value of the GPIO port input register (see portInputRegister()) that includes the pushbutton pin
+      uint32_t now: time of the sample (ms)
+    Returns: None
+*/
+PB_FASTRUN void pushButtonClass::updateSample(uint32_t sample, uint32_t now) {
+  PB_COUNT(updates);
+  if (!inLockout(now))
+    runState(((sample & pinMask) == activeSample), now);
+}
+
+
+/* pushButtonClass::updateBlock()
+    Processes a block of GPIO port samples taken at a fixed interval (e.g. by a timer or DMA), in one pass. Equivalent to
+      calling updateSample() for each sample. Only the last event detected in the block can be read with getEvent(), etc.; 
+      attach an event ring (see attachRing()) to see every event.
+    Parameters:
+      const uint32_t *samples: GPIO port samples, oldest first (see updateSample())
+      uint16_t count: number of samples
+      uint16_t samplePeriod: interval between samples (ms)
+      uint32_t lastTime: time of the last sample (ms)
+    Returns: None
+*/
+PB_FASTRUN void pushButtonClass::updateBlock(const uint32_t *samples, uint16_t count, uint16_t samplePeriod, uint32_t lastTime) {
+  uint32_t now;
+  uint16_t i;
+
+  if (count == 0)
+    return;
+  now = lastTime - ((uint32_t) (count - 1) * samplePeriod);   // time of first sample
+  for (i = 0; i < count; i++) {
+    updateSample(samples[i], now);
+    now += samplePeriod;
+  }
+}
+
+/* pushButtonClass::updateBlock()
+    Same as above, for a block whose last sample was taken at millis().
+    Parameters:
+      const uint32_t *samples: GPIO port samples, oldest first (see updateSample())
+      uint16_t count: number of samples
+      uint16_t samplePeriod: interval between samples (ms)
+    Returns: None
+*/
+PB_FASTRUN void pushButtonClass::updateBlock(const uint32_t *samples, uint16_t count, uint16_t samplePeriod) {
+  PB_COUNT(clockReads);
+  updateBlock(samples, count, samplePeriod, millis());
+}
+
+
+/* pushButtonClass::nextDeadline()
+    Finds the earliest time after "now" at which a debounce lockout or delay expires. If the input doesn't change, and the 
+      last update changed neither the state nor the lockout, then updates before this time have no effect. Used by the
+      discrete-event simulator (see PushbuttonSim.h) and by updateEdges() to skip idle periods.
+    Parameters:
+      uint32_t now: time of the last update (ms)
+      uint32_t &deadline: receives the deadline (ms)
+    Returns:
+      bool: true if there is a deadline; false if nothing can happen until the input changes
+*/
+PB_FASTRUN bool pushButtonClass::nextDeadline(uint32_t now, uint32_t &deadline) {
+  uint32_t t[2];
+  uint8_t n = 0, i;
+  bool found = false;
+
+  if (lockout)
+    t[n++] = lockoutStart + debouncePeriod + 1;
+  if ((state == WAIT_LONG) && longPressEnabled)
+    t[n++] = delayStart + longPressDuration + 1;
+  else if (state == WAIT_DOUBLE)
+    t[n++] = delayStart + doubleTapDelay + 1;
+#ifdef PB_DOUBLE_TAP_HOLD
+  else if (state == WAIT_DOUBLE_HOLD)
+    t[n++] = delayStart + longPressDuration + 1;
+#endif
+  for (i = 0; i < n; i++) {
+    if ((int32_t) (t[i] - now) <= 0)   // already passed (e.g. during lockout); handled after lockout ends
+      continue;
+    if (!found || ((int32_t) (t[i] - deadline) < 0)) {
+      deadline = t[i];
+      found = true;
+    }
+  }
+  return (found);
+}
+
+
+/* pushButtonClass::getState() 
+    Returns the current state of the pushbutton (see stateEnum in Pushbutton.h).
+    Parameters: None
+    Returns:
+      stateEnum: current state
+*/
+stateEnum pushButtonClass::getState() {
+  return (state);
+}
+
+
+/* pushButtonClass::lockedOut() 
+    Returns true if the pushbutton is in its debounce lockout period.
+    Parameters: None
+    Returns:
+      bool: true if in lockout
+*/
+bool pushButtonClass::lockedOut() {
+  return (lockout);
+}
+
+
+/* pushButtonClass::holdProgress() 
+    Returns how far a press has progressed towards a long press (or double-tap-and-hold), e.g. for visual feedback.
+    Parameters:
+      uint32_t now: current time (ms)
+    Returns:
+      uint8_t: 0 (just pressed) to 255 (long-press duration reached); 0 if not waiting for a long press
+*/
+PB_FASTRUN uint8_t pushButtonClass::holdProgress(uint32_t now) {
+  uint32_t elapsed;
+
+  if (!((state == WAIT_LONG) && longPressEnabled) && (state != WAIT_DOUBLE_HOLD))
+    return (0);
+  elapsed = now - delayStart;
+  if (elapsed >= longPressDuration)
+    return (255);
+  return ((elapsed * 255) / longPressDuration);
+}
+
+
+/* pushButtonClass::saveState() 
+    Saves the dynamic state of the pushbutton (state, event, lockout and delay timers), e.g. to checkpoint a simulation.
+    Parameters:
+      pbButtonState &st: receives the state
+    Returns: None
+*/
+void pushButtonClass::saveState(pbButtonState &st) {
+  st.lockoutStart = lockoutStart;
+  st.delayStart = delayStart;
+  st.state = state;
+  st.event = event;
+  st.lockout = lockout;
+  st.buttonActive = buttonActive;
+}
+
+
+/* pushButtonClass::restoreState() 
+    Restores the dynamic state previously saved with saveState(). The pushbutton must have the same configuration as when
+      the state was saved.
+    Parameters:
+      const pbButtonState &st: saved state
+    Returns: None
+*/
+void pushButtonClass::restoreState(const pbButtonState &st) {
+  lockoutStart = st.lockoutStart;
+  delayStart = st.delayStart;
+  state = (stateEnum) st.state;
+  event = (eventEnum) st.event;
+  lockout = st.lockout;
+  buttonActive = st.buttonActive;
+}
+
+
+#ifdef PB_EDGE_CAPTURE
+/* pushButtonClass::captureEdge()
+    Records a timestamped edge of the pushbutton input, e.g. from a QuadTimer input-capture channel
+      (see PushbuttonCapture.h). Can be called from an interrupt. The edge is dropped if edgeFifoSize edges are already 
+      waiting to be processed by updateEdges().
+    Parameters:
+      uint8_t level: logic level of the pin after the edge (HIGH or LOW)
+      uint32_t timeUs: time of the edge (micros())
+    Returns: None
+*/
+PB_FASTRUN void pushButtonClass::captureEdge(uint8_t level, uint32_t timeUs) {
+  uint8_t n = edgeHead & (edgeFifoSize - 1);
+
+  if ((uint8_t) (edgeHead - edgeTail) >= edgeFifoSize)  // FIFO full
+    return;
+  edgeTime[n] = timeUs;
+  if (level == activeLevel)
+    edgeLevels |= (1 << n);
+  else
+    edgeLevels &= ~(1 << n);
+  edgeHead++;
+}
+
+
+/* pushButtonClass::updateEdges()
+    Used in place of update() for pushbuttons whose edges are captured with captureEdge(). Each captured edge is run through 
+      the debounce and event logic at the time it occurred, and lockout and delay deadlines that expired between edges are
+      run at the time they expired, so events are detected with the same timing as update() called every millisecond, 
+      however often updateEdges() is called. It must still be called often enough that no more than edgeFifoSize edges
+      are captured between calls, and events are only reported when it is called.
+    Parameters: None
+    Returns: None
+*/
+PB_FASTRUN void pushButtonClass::updateEdges() {
+  uint32_t nowMs, nowUs, t;
+  uint8_t head, n;
+
+  head = edgeHead;   // edges captured after this point are left for the next call
+  PB_COUNT(clockReads);
+  nowMs = millis();
+  nowUs = micros();
+  while (edgeTail != head) {
+    n = edgeTail & (edgeFifoSize - 1);
+    t = edgeTime[n];
+    runEdge((edgeLevels & (1 << n)), nowMs - ((nowUs - t) / 1000), t);  // edge time converted to millis() time base
+    edgeTail++;
+  }
+  runEdge(edgeActive, nowMs, levelTime);  // no edges pending, so input is unchanged since the last edge
+}
+
+
+/* pushButtonClass::runEdge()
+    Runs the state machine for an input level that holds from time "now". First, the previous level is run at the times 
+      since the last run at which update() called every millisecond could have had an effect: the next millisecond after 
+      a change of state or lockout, and otherwise the next lockout or delay deadline (see nextDeadline()). The state 
+      machine is run at most once per millisecond; a level that starts in the same millisecond as the last run takes 
+      effect at the next millisecond.
+    Parameters:
+      bool active: input level from "now" onwards (true if pressed)
+      uint32_t now: time (ms); earlier times than the last run are treated as the time of the last run
+      uint32_t timeUs: capture time of the edge (micros()), for pressMicros()
+    Returns: None
+*/
+PB_FASTRUN void pushButtonClass::runEdge(bool active, uint32_t now, uint32_t timeUs) {
+  uint32_t t = evalTime + 1, deadline;
+
+  if ((int32_t) (now - evalTime) < 0)   // edge captured just before the previous millis() read
+    now = evalTime;
+  while ((int32_t) (t - now) < 0) {
+    if (stepEdge(t))
+      t++;    // the new state may act on the same input at the next update
+    else if (nextDeadline(t, deadline))
+      t = deadline;
+    else
+      break;  // nothing can happen until the input changes
+  }
+  edgeActive = active;
+  levelTime = timeUs;
+  if (now != evalTime) {
+    evalTime = now;
+    stepEdge(now);
+  }
+}
+
+
+/* pushButtonClass::stepEdge()
+    Runs the state machine once at time "now" with the current edge-capture input level, as update() would.
+    Parameters:
+      uint32_t now: time (ms)
+    Returns:
+      bool: true if the state or lockout changed
+*/
+PB_FASTRUN bool pushButtonClass::stepEdge(uint32_t now) {
+  stateEnum prevState = state;
+  bool prevLockout = lockout;
+
+  PB_COUNT(updates);
+  if (!inLockout(now)) {
+    runState(edgeActive, now);
+    if (lockout && edgeActive)  // press was accepted
+      pressTime = levelTime;
+  }
+  return ((state != prevState) || (lockout != prevLockout));
+}
+
+
+/* pushButtonClass::pressMicros() 
+    Returns the capture time of the edge that started the last accepted (debounced) press, e.g. for tap tempo.
+    Parameters: None
+    Returns:
+      uint32_t: time of the press edge (micros())
+*/
+uint32_t pushButtonClass::pressMicros() {
+  return (pressTime);
+}
+#endif
+
+
+/* pushButtonClass::inLockout()
+    Checks for the end of the debounce lockout period. 
+    Parameters:
+      uint32_t now: current time (ms)
+    Returns:
+      bool: true if the pushbutton was in lockout, in which case the pin is not read. When the lockout period has just 
+        expired, true is still returned and other actions are handled in the next call.
+*/
+PB_FASTRUN bool pushButtonClass::inLockout(uint32_t now) {
+  if (!lockout)
+    return (false);
+  PB_COUNT(lockoutSkips);
+  if ((now - lockoutStart) > debouncePeriod)  // if debounce period expired
+    lockout = false;   // end lockout, handle other actions in next call to update()
+  return (true);
+}
+
+
+/* pushButtonClass::runState()
+    Runs the pushbutton state machine for one (non-lockout) update.
+    Parameters:
+      bool active: current level of the switch (true if pressed)
+      uint32_t now: current time (ms)
+    Returns: None
+*/
+PB_FASTRUN void pushButtonClass::runState(bool active, uint32_t now) {
+#ifdef PB_INSTRUMENT
+  stateEnum prevState = state;
+#endif
+  buttonActive = active;
+  switch (state) {   // actions depend on current state
+    case RDY:   // waiting for switch press
+      if (buttonActive) {  // button was pressed
+        lockout = true;  // start lockout period
+        lockoutStart = now;  // start lockout period
+        delayStart = now;  // start delay timer for other possible actions
+        if (doubleTapEnabled || longPressEnabled)   // if either of these functions are enabled
+          state = WAIT_LONG;   // transition to the next state, used by both functions
+        else {  // neither function is enabled
+          setEvent(SINGLE_TAP, now);  // record the press event immediately (no delays to wait for possible long- or double-)
+          state = WAIT_INACTIVE;   // go to this state to wait for switch release
         }
-        else {  // switch was just released
-          lockout = true;  // start debounce lockout period
-          lockoutTimer = 0;  
-          if (doubleTapEnabled)  // if this function is enabled
-            state = WAIT_DOUBLE; // transition to this state to wait for possible second press
-          else {  // double-tap not enabled
-            event = SINGLE_TAP;  // it was just a single-tap; report immediately without waiting for end of release debounce
-            state = RDY;   // go to RDY state and wait for end of (release) debounce period
+      } 
+    break;
+    case WAIT_LONG:   // button was pressed and either double-tap or long-press functions are enabled
+      if (buttonActive) {  // if switch is still active (not yet released)
+        if (longPressEnabled) {
+          if ((now - delayStart) > longPressDuration) {   // if long-press delay has expired
+            setEvent(LONG_PRESS, now);  // record the event
+            state = WAIT_INACTIVE;   // go to this state to wait for button release
           }
         }
-      break;
-      case WAIT_DOUBLE: // button was pressed and released, now waiting for possible second press (after debounce)
-        if (delayTimer > doubleTapDelay) {  // end of waiting period for double-tap
-          event = SINGLE_TAP;  // it was just a single-tap
-          state = RDY;   // // go to ready state (but note that release debounce lockout was previously started)
+      }
+      else {  // switch was just released
+        lockout = true;  // start debounce lockout period
+        lockoutStart = now;
+        if (doubleTapEnabled)  // if this function is enabled
+          state = WAIT_DOUBLE; // transition to this state to wait for possible second press
+        else {  // double-tap not enabled
+          setEvent(SINGLE_TAP, now);  // it was just a single-tap; report immediately without waiting for end of release debounce
+          state = RDY;   // go to RDY state and wait for end of (release) debounce period
         }
-        else {  // double-tap delay hasn't ended
-          if (buttonActive) {  // button pressed again within double-tap period
-            lockout = true;    // start debounce lockout
-            lockoutTimer = 0;
-            event = DOUBLE_TAP;    // record double-tap event
-            state = WAIT_INACTIVE; // go to this state to wait for button release
+      }
+    break;
+    case WAIT_DOUBLE: // button was pressed and released, now waiting for possible second press (after debounce)
+      if ((now - delayStart) > doubleTapDelay) {  // end of waiting period for double-tap
+        setEvent(SINGLE_TAP, now);  // it was just a single-tap
+        state = RDY;   // // go to ready state (but note that release debounce lockout was previously started)
+      }
+      else {  // double-tap delay hasn't ended
+        if (buttonActive) {  // button pressed again within double-tap period
+          lockout = true;    // start debounce lockout
+          lockoutStart = now;
+#ifdef PB_DOUBLE_TAP_HOLD
+          if (doubleTapHoldEnabled) {  // second press may be held
+            delayStart = now;  // start delay timer for hold duration
+            state = WAIT_DOUBLE_HOLD;  // go to this state to wait for hold duration or button release
+            break;
           }
+#endif
+          setEvent(DOUBLE_TAP, now);    // record double-tap event
+          state = WAIT_INACTIVE; // go to this state to wait for button release
         }
-      break;
-      case WAIT_INACTIVE: // waiting for button to be released before returning to RDY state
-        if (!buttonActive) {   // switch was released
-          lockout = true;    // start debounce lockout
-          lockoutTimer = 0;
-          state = RDY;   // return to ready state
+      }
+    break;
+#ifdef PB_DOUBLE_TAP_HOLD
+    case WAIT_DOUBLE_HOLD:  // button was pressed a second time and double-tap-and-hold function is enabled
+      if (buttonActive) {  // if switch is still active (not yet released)
+        if ((now - delayStart) > longPressDuration) {   // if hold duration has expired
+          setEvent(DOUBLE_TAP_HOLD, now);  // record the event
+          state = WAIT_INACTIVE;   // go to this state to wait for button release
         }
-      break;
-      default:
-      break;
-    }
+      }
+      else {  // switch was released before hold duration; it was just a double-tap
+        lockout = true;  // start debounce lockout period
+        lockoutStart = now;
+        setEvent(DOUBLE_TAP, now);
+        state = RDY;   // go to RDY state and wait for end of (release) debounce period
+      }
+    break;
+#endif
+    case WAIT_INACTIVE: // waiting for button to be released before returning to RDY state
+      if (!buttonActive) {   // switch was released
+        lockout = true;    // start debounce lockout
+        lockoutStart = now;
+        state = RDY;   // return to ready state
+      }
+    break;
+    default:
+    break;
   }
+#ifdef PB_INSTRUMENT
+  if (state != prevState)
+    PB_COUNT(transitions);
+#endif
 }
 
 
@@ -173,6 +599,25 @@ bool pushButtonClass::longPress() {
 }
 
 
+#ifdef PB_DOUBLE_TAP_HOLD
+/* pushButtonClass::doubleTapHold() 
+    returns true if the periodically-called update() function has detected a double-tap-and-hold event. The state
+      variable pb.event is cleared, so doubleTapHold() will return true only once for each event.
+    Parameters: None
+    Returns:
+      bool: true (one time) if DOUBLE_TAP_HOLD event has been detected
+*/
+bool pushButtonClass::doubleTapHold() {
+  if (event == DOUBLE_TAP_HOLD) {
+    event = NO_PRESS;
+    return (true);
+  }
+  else 
+    return (false);
+}
+#endif
+
+
 /* pushButtonClass::eventDetected() 
     returns true if the periodically-called update() function has detected any type of putton-press event, and the event has not 
       been cleared by a call to singleTap(), doubleTap(), longPress(), or getEvent(). This call does not clear the event.
@@ -196,4 +641,31 @@ eventEnum pushButtonClass::getEvent() {
   v = event;
   event = NO_PRESS;
   return (v);
-}
\ No newline at end of file
+}
+
+
+#ifdef PB_INSTRUMENT
+/* pushButtonClass::getOpCounts() 
+    Copies the operation counts of this pushbutton since init() or the last call to resetOpCounts(). Counts totalled over 
+      all pushbuttons are in the global pbTotalOps; the counts for one scan of several pushbuttons can be found by taking 
+      a copy of pbTotalOps before and after the scan. Pin and clock reads shared by a bank or sampler are only counted in
+      pbTotalOps, so for a pushbutton updated that way they stay at 0 here (updates, transitions and lockoutSkips are
+      still counted).
+    Parameters:
+      pbOpCounts &snap: receives the counts
+    Returns: None
+*/
+void pushButtonClass::getOpCounts(pbOpCounts &snap) {
+  snap = ops;
+}
+
+
+/* pushButtonClass::resetOpCounts() 
+    Clears the operation counts of this pushbutton (pbTotalOps is not changed).
+    Parameters: None
+    Returns: None
+*/
+void pushButtonClass::resetOpCounts() {
+  memset(&ops, 0, sizeof(ops));
+}
+#endif
@@ -0,0 +1,210 @@
+/* PUSHBUTTONBANK.CPP
+    Implements a pushButtonBankClass that updates a group of pushbuttons with a single port-wide read of their GPIO port, 
+      either live (update()) or from a block of previously captured port samples (updateBlock()).
+*/
+
+#include <Arduino.h>
+#include "PushbuttonBank.h"
+#include "PushbuttonFeedback.h"
+
+#ifdef PB_INSTRUMENT
+#define PB_COUNT_TOTAL(field) do { pbTotalOps.field++; } while (0)   // shared by all pushbuttons in the bank
+#else
+#define PB_COUNT_TOTAL(field) do { } while (0)
+#endif
+
+
+/* pushButtonBankClass::init()
+    Initializes the bank. 
+    Parameters:
+      pushButtonClass *btns: array of pushbuttons, each previously initialized with init()
+      uint8_t count: number of elements in btns[]
+    Returns: None
+*/
+PB_FLASHMEM void pushButtonBankClass::init(pushButtonClass *btns, uint8_t count) {
+  buttons = btns;
+  feedback = NULL;
+  setCount(count);
+}
+
+
+/* pushButtonBankClass::setCount()
+    Changes the number of pushbuttons in the bank (the first count elements of the array passed to init()), e.g. when a
+      pool adds or removes pushbuttons, and finds their shared GPIO port again. The attached feedback outputs are kept.
+    Parameters:
+      uint8_t count: number of pushbuttons, each previously initialized with init()
+    Returns: None
+*/
+PB_FLASHMEM void pushButtonBankClass::setCount(uint8_t count) {
+  uint8_t i;
+
+  numButtons = count;
+  portIn = (count > 0) ? portInputRegister(buttons[0].pNum) : NULL;
+  portMask = 0;
+  for (i = 0; i < count; i++) {
+    if (portInputRegister(buttons[i].pNum) != portIn) {  // pushbuttons are on different ports
+      portIn = NULL;   // update() falls back to reading each pin
+      portMask = 0;
+      break;
+    }
+    portMask |= digitalPinToBitMask(buttons[i].pNum);
+  }
+}
+
+
+/* pushButtonBankClass::attachFeedback()
+    Attaches feedback outputs (e.g. button LEDs, see PushbuttonFeedback.h), which are then updated from the pushbutton 
+      states at the end of every update() or updateBlock(), in the same scan.
+    Parameters:
+      pushButtonFeedbackClass *fb: feedback outputs, previously initialized with init(); NULL to detach
+    Returns: None
+*/
+PB_FLASHMEM void pushButtonBankClass::attachFeedback(pushButtonFeedbackClass *fb) {
+  feedback = fb;
+}
+
+
+/* pushButtonBankClass::update()
+    Called periodically to update all pushbuttons in the bank (see pushButtonClass::update()). If the pushbuttons share a 
+      GPIO port, the port is read once; otherwise each pushbutton reads its own pin.
+    Parameters: None
+    Returns: None
+*/
+PB_FASTRUN void pushButtonBankClass::update() {
+  uint32_t now, sample;
+  uint8_t i;
+
+  if (portIn == NULL) {
+    for (i = 0; i < numButtons; i++)
+      buttons[i].update();
+    if (feedback != NULL) {
+      PB_COUNT_TOTAL(clockReads);
+      feedback->apply(this, millis());
+    }
+    return;
+  }
+  PB_COUNT_TOTAL(clockReads);
+  now = millis();
+  PB_COUNT_TOTAL(pinReads);
+  sample = *portIn;   // port-wide read of all pushbuttons
+  for (i = 0; i < numButtons; i++)
+    buttons[i].updateSample(sample, now);
+  if (feedback != NULL)
+    feedback->apply(this, now);
+}
+
+
+/* pushButtonBankClass::updateBlock()
+    Processes a block of GPIO port samples for all pushbuttons in the bank (see pushButtonClass::updateBlock()). Each 
+      sample is passed to every pushbutton before the next one, so that events published to a shared ring are in time
+      order across pushbuttons. All pushbuttons must be on the sampled port; if they are on different ports (getPort() 
+      returns NULL), the block is ignored.
+    Parameters:
+      const uint32_t *samples: GPIO port samples, oldest first
+      uint16_t count: number of samples
+      uint16_t samplePeriod: interval between samples (ms)
+      uint32_t lastTime: time of the last sample (ms)
+    Returns: None
+*/
+PB_FASTRUN void pushButtonBankClass::updateBlock(const uint32_t *samples, uint16_t count, uint16_t samplePeriod, uint32_t lastTime) {
+  uint32_t now;
+  uint16_t s;
+  uint8_t i;
+
+  if ((portIn == NULL) || (count == 0))   // a single port sample doesn't contain all of the pushbuttons
+    return;
+  now = lastTime - ((uint32_t) (count - 1) * samplePeriod);   // time of first sample
+  for (s = 0; s < count; s++) {
+    for (i = 0; i < numButtons; i++)
+      buttons[i].updateSample(samples[s], now);
+    now += samplePeriod;
+  }
+  if (feedback != NULL)
+    feedback->apply(this, lastTime);
+}
+
+/* pushButtonBankClass::updateBlock()
+    Same as above, for a block whose last sample was taken at millis().
+    Parameters:
+      const uint32_t *samples: GPIO port samples, oldest first
+      uint16_t count: number of samples
+      uint16_t samplePeriod: interval between samples (ms)
+    Returns: None
+*/
+PB_FASTRUN void pushButtonBankClass::updateBlock(const uint32_t *samples, uint16_t count, uint16_t samplePeriod) {
+  PB_COUNT_TOTAL(clockReads);
+  updateBlock(samples, count, samplePeriod, millis());
+}
+
+
+/* pushButtonBankClass::saveState()
+    Saves the dynamic state of every pushbutton in the bank (see pushButtonClass::saveState()).
+    Parameters:
+      pbButtonState *states: receives the states; must have getCount() elements
+    Returns: None
+*/
+void pushButtonBankClass::saveState(pbButtonState *states) {
+  uint8_t i;
+
+  for (i = 0; i < numButtons; i++)
+    buttons[i].saveState(states[i]);
+}
+
+
+/* pushButtonBankClass::restoreState()
+    Restores the dynamic state of every pushbutton in the bank, previously saved with saveState().
+    Parameters:
+      const pbButtonState *states: saved states; must have getCount() elements
+    Returns: None
+*/
+void pushButtonBankClass::restoreState(const pbButtonState *states) {
+  uint8_t i;
+
+  for (i = 0; i < numButtons; i++)
+    buttons[i].restoreState(states[i]);
+}
+
+
+/* pushButtonBankClass::getCount()
+    Returns the number of pushbuttons in the bank.
+    Parameters: None
+    Returns:
+      uint8_t: number of pushbuttons
+*/
+uint8_t pushButtonBankClass::getCount() {
+  return (numButtons);
+}
+
+
+/* pushButtonBankClass::getButton()
+    Returns a pushbutton in the bank, e.g. to read its events.
+    Parameters:
+      uint8_t index: index of the pushbutton (0 to getCount() - 1)
+    Returns:
+      pushButtonClass *: pushbutton, or NULL if index is out of range
+*/
+pushButtonClass *pushButtonBankClass::getButton(uint8_t index) {
+  return ((index < numButtons) ? &buttons[index] : NULL);
+}
+
+
+/* pushButtonBankClass::getPort()
+    Returns the GPIO port input register shared by all pushbuttons in the bank (e.g. to set up sampling by a timer or DMA).
+    Parameters: None
+    Returns:
+      volatile uint32_t *: port input register, or NULL if the pushbuttons are on different ports
+*/
+volatile uint32_t *pushButtonBankClass::getPort() {
+  return (portIn);
+}
+
+
+/* pushButtonBankClass::getPortMask()
+    Returns the bit mask of all pushbutton pins in the shared GPIO port (see getPort()).
+    Parameters: None
+    Returns:
+      uint32_t: bit mask of pushbutton pins; 0 if the pushbuttons are on different ports
+*/
+uint32_t pushButtonBankClass::getPortMask() {
+  return (portMask);
+}
@@ -0,0 +1,183 @@
+/* PUSHBUTTONCAL.CPP
+    Implements a pushButtonCalClass that saves the timing values (see pushButtonClass::setDelays()) of a group of pushbuttons
+      in EEPROM, so that tuned values are applied immediately at the next power-up. Records are protected by a CRC and written
+      to a ring of slots (wear levelling); writes are skipped when the values have not changed.
+    When PB_CAL_EMULATE_EEPROM is defined, a RAM array is used in place of EEPROM (e.g. for host testing).
+*/
+
+#include <Arduino.h>
+#include "PushbuttonCal.h"
+
+#ifdef PB_CAL_EMULATE_EEPROM
+uint8_t calEmuEeprom[calEmuSize];   // emulated EEPROM contents
+#else
+#include <EEPROM.h>
+#endif
+
+
+/* pushButtonCalClass::init()
+    Initializes the calibration store. Call load() afterwards to apply the saved values.
+    Parameters:
+      uint16_t eepromAddr: EEPROM address of the first slot. calNumSlots * sizeof(pbCalRecord) bytes are used.
+    Returns: None
+*/
+PB_FLASHMEM void pushButtonCalClass::init(uint16_t eepromAddr) {
+  baseAddr = eepromAddr;
+  curSlot = 0;
+  curValid = false;
+}
+
+
+/* pushButtonCalClass::load()
+    Finds the current calibration record and applies its timing values to the pushbuttons, in order. Only the slot headers
+      and a single full record are read (unless the newest record is corrupted, in which case the next newest is tried).
+    Parameters:
+      pushButtonClass *buttons: array of pushbuttons, previously initialized with init()
+      uint8_t numButtons: number of elements in buttons[]
+    Returns:
+      bool: true if a valid record was found and applied; false if the pushbuttons keep their current values
+*/
+PB_FLASHMEM bool pushButtonCalClass::load(pushButtonClass *buttons, uint8_t numButtons) {
+  uint8_t i;
+
+  if (!findCurrent())
+    return (false);
+  for (i = 0; (i < numButtons) && (i < rec.numButtons); i++)
+    buttons[i].setDelays(rec.entry[i].debouncePeriod, rec.entry[i].doubleTapDelay, rec.entry[i].longPressDuration);
+  return (true);
+}
+
+
+/* pushButtonCalClass::save()
+    Saves the timing values of the pushbuttons to the slot after the newest valid record (found in EEPROM if load() has not
+      been called). Nothing is written if the values are unchanged from the current record.
+    Parameters:
+      pushButtonClass *buttons: array of pushbuttons
+      uint8_t numButtons: number of elements in buttons[] (max calMaxButtons)
+    Returns:
+      bool: true if the values are saved; false if numButtons is too large
+*/
+PB_FLASHMEM bool pushButtonCalClass::save(pushButtonClass *buttons, uint8_t numButtons) {
+  pbCalRecord newRec;
+  uint8_t i;
+
+  if (numButtons > calMaxButtons)
+    return (false);
+  memset(&newRec, 0, sizeof(newRec));
+  newRec.numButtons = numButtons;
+  for (i = 0; i < numButtons; i++)
+    buttons[i].getDelays(newRec.entry[i].debouncePeriod, newRec.entry[i].doubleTapDelay, newRec.entry[i].longPressDuration);
+  if (!curValid)
+    findCurrent();   // e.g. saving after init() without load(); continue from the newest record in EEPROM
+  if (curValid) {
+    newRec.seq = rec.seq;   // so that the comparison below covers only the values
+    newRec.crc = rec.crc;
+    if (memcmp(&newRec, &rec, sizeof(newRec)) == 0)   // values unchanged
+      return (true);    // skip the write to save wear
+    newRec.seq = rec.seq + 1;
+    curSlot = (curSlot + 1) % calNumSlots;    // move to next slot
+  }
+  else {    // no valid record in any slot; start over at the first slot
+    newRec.seq = 0;
+    curSlot = 0;
+  }
+  newRec.crc = calcCrc(newRec);
+  writeBytes(baseAddr + (curSlot * sizeof(pbCalRecord)), (const uint8_t *) &newRec, sizeof(newRec));
+  rec = newRec;
+  curValid = true;
+  return (true);
+}
+
+
+/* pushButtonCalClass::findCurrent()
+    Reads the sequence number of each slot and loads the newest record with a valid CRC into rec.
+    Parameters: None
+    Returns:
+      bool: true if a valid record was found
+*/
+PB_FLASHMEM bool pushButtonCalClass::findCurrent() {
+  uint16_t seq[calNumSlots];
+  uint8_t rejected = 0;   // bit mask of slots that failed the CRC check
+  uint8_t slot, best;
+  bool found;
+
+  for (slot = 0; slot < calNumSlots; slot++)
+    readBytes(baseAddr + (slot * sizeof(pbCalRecord)), (uint8_t *) &seq[slot], sizeof(uint16_t));
+  curValid = false;
+  do {
+    found = false;
+    best = 0;
+    for (slot = 0; slot < calNumSlots; slot++) {
+      if (rejected & (1 << slot))
+        continue;
+      if (!found || ((int16_t) (seq[slot] - seq[best]) > 0)) {  // newer, allowing for sequence number wrap-around
+        best = slot;
+        found = true;
+      }
+    }
+    if (found) {
+      readBytes(baseAddr + (best * sizeof(pbCalRecord)), (uint8_t *) &rec, sizeof(rec));
+      if ((rec.crc == calcCrc(rec)) && (rec.numButtons <= calMaxButtons)) {
+        curSlot = best;
+        curValid = true;
+      }
+      else
+        rejected |= (1 << best);
+    }
+  } while (found && !curValid);
+  return (curValid);
+}
+
+
+/* pushButtonCalClass::calcCrc()
+    Calculates the CRC-16/CCITT of a record, excluding the crc field.
+    Parameters:
+      const pbCalRecord &r: record
+    Returns:
+      uint16_t: CRC value
+*/
+PB_FLASHMEM uint16_t pushButtonCalClass::calcCrc(const pbCalRecord &r) {
+  const uint8_t *p = (const uint8_t *) &r;
+  uint16_t crc = 0xFFFF;
+  uint16_t i;
+  uint8_t b;
+
+  for (i = 0; i < offsetof(pbCalRecord, crc); i++) {
+    crc ^= ((uint16_t) p[i] << 8);
+    for (b = 0; b < 8; b++)
+      crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+  }
+  return (crc);
+}
+
+
+/* pushButtonCalClass::readBytes()
+    Reads a block of bytes from (real or emulated) EEPROM. Bytes outside the emulated EEPROM are read as 0 (which fails the
+      CRC check of a record).
+*/
+PB_FLASHMEM void pushButtonCalClass::readBytes(uint16_t addr, uint8_t *dst, uint16_t len) {
+#ifdef PB_CAL_EMULATE_EEPROM
+  if ((addr + len) <= calEmuSize)
+    memcpy(dst, &calEmuEeprom[addr], len);
+  else
+    memset(dst, 0, len);
+#else
+  while (len--)
+    *dst++ = EEPROM.read(addr++);
+#endif
+}
+
+
+/* pushButtonCalClass::writeBytes()
+    Writes a block of bytes to (real or emulated) EEPROM. On real EEPROM, bytes that already hold the correct value are not
+      rewritten.
+*/
+PB_FLASHMEM void pushButtonCalClass::writeBytes(uint16_t addr, const uint8_t *src, uint16_t len) {
+#ifdef PB_CAL_EMULATE_EEPROM
+  if ((addr + len) <= calEmuSize)
+    memcpy(&calEmuEeprom[addr], src, len);
+#else
+  while (len--)
+    EEPROM.update(addr++, *src++);
+#endif
+}
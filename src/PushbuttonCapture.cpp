@@ -0,0 +1,243 @@
+/* PUSHBUTTONCAPTURE.CPP
+    Implements a pushButtonCaptureClass that timestamps pushbutton edges as they occur and passes them to
+      pushButtonClass::captureEdge(), for microsecond-accurate press timing (e.g. tap tempo). On the target, each pushbutton
+      pin is switched to a QuadTimer input, and the timer channel captures its free-running counter on both edges. The
+      QuadTimer interrupt reads the captured value, re-arms the capture and converts the value to micros() time.
+*/
+
+#include <Arduino.h>
+#include "PushbuttonCapture.h"
+
+#ifdef PB_EDGE_CAPTURE
+
+pushButtonClass *pushButtonCaptureClass::slotButton[captureMaxButtons] = {NULL};
+uint32_t pushButtonCaptureClass::tickScale;
+
+#ifndef PB_MOCK_CAPTURE
+uint8_t pushButtonCaptureClass::slotInput[captureMaxButtons];
+
+  /* Pin connected to a QuadTimer input (Teensy 4.0). The pin is switched to mux mode ALT1; the QuadTimer2/3 inputs also
+      need their input select (daisy chain) register set.
+  */
+struct pbCaptureInput {
+  uint8_t pin;
+  uint8_t module;   // 0-2 for TMR1-3
+  uint8_t channel;  // 0-3
+  volatile uint32_t *selectInput;   // input select register (NULL if none)
+};
+
+static const pbCaptureInput captureInputs[] = {
+  {10, 0, 0, NULL},
+  {12, 0, 1, NULL},
+  {11, 0, 2, NULL},
+  {13, 1, 0, &IOMUXC_QTIMER2_TIMER0_SELECT_INPUT},
+  {19, 2, 0, &IOMUXC_QTIMER3_TIMER0_SELECT_INPUT},
+  {18, 2, 1, &IOMUXC_QTIMER3_TIMER1_SELECT_INPUT},
+  {14, 2, 2, &IOMUXC_QTIMER3_TIMER2_SELECT_INPUT},
+  {15, 2, 3, &IOMUXC_QTIMER3_TIMER3_SELECT_INPUT},
+};
+const uint8_t numCaptureInputs = sizeof(captureInputs) / sizeof(captureInputs[0]);
+
+static IMXRT_TMR_t * const tmrModule[3] = {&IMXRT_TMR1, &IMXRT_TMR2, &IMXRT_TMR3};
+static const IRQ_NUMBER_t tmrIrq[3] = {IRQ_QTIMER1, IRQ_QTIMER2, IRQ_QTIMER3};
+static const uint32_t tmrClockGate[3] = {CCM_CCGR6_QTIMER1(CCM_CCGR_ON), CCM_CCGR6_QTIMER2(CCM_CCGR_ON),
+  CCM_CCGR6_QTIMER3(CCM_CCGR_ON)};
+static const uint32_t muxQuadTimer = 1;     // pad mux mode ALT1: QuadTimer input
+static const uint32_t muxGpio = 5 | 0x10;   // pad mux mode ALT5 (GPIO) with SION, as set by pinMode()
+#endif
+
+
+/* pushButtonCaptureClass::attach()
+    Routes a pushbutton to a free capture slot and starts capturing its edges. On the target, the pushbutton's pin is
+      switched from GPIO to its QuadTimer input; the pad settings made by pushButtonClass::init() (pullup) are kept. The
+      tick length is set from the current bus clock (see setBusClock()).
+    Parameters:
+      pushButtonClass *btn: pushbutton, previously initialized with init()
+    Returns:
+      int8_t: capture slot number; -1 if all slots are in use or the pin has no QuadTimer input
+*/
+PB_FLASHMEM int8_t pushButtonCaptureClass::attach(pushButtonClass *btn) {
+#ifndef PB_MOCK_CAPTURE
+  static void (* const isrs[3])() = {isrTmr1, isrTmr2, isrTmr3};
+  const pbCaptureInput *in;
+  volatile uint16_t *enbl;
+  uint8_t i;
+#endif
+  uint8_t slot;
+
+  for (slot = 0; slot < captureMaxButtons; slot++) {
+    if (slotButton[slot] == btn)  // already attached
+      return (slot);
+  }
+  for (slot = 0; (slot < captureMaxButtons) && (slotButton[slot] != NULL); slot++)
+    ;
+  if (slot >= captureMaxButtons)
+    return (-1);
+  setBusClock(F_BUS_ACTUAL);
+#ifndef PB_MOCK_CAPTURE
+  for (i = 0; (i < numCaptureInputs) && (captureInputs[i].pin != btn->pNum); i++)
+    ;
+  if (i >= numCaptureInputs)
+    return (-1);
+  in = &captureInputs[i];
+  IMXRT_TMR_CH_t *ch = &tmrModule[in->module]->CH[in->channel];
+
+  CCM_CCGR6 |= tmrClockGate[in->module];
+  ch->CTRL = 0;   // stop the channel while it is configured
+  ch->SCTRL = 0;
+  ch->CSCTRL = 0;
+  ch->FILT = 0;
+  ch->LOAD = 0;
+  ch->CNTR = 0;
+  ch->SCTRL = TMR_SCTRL_CAPTURE_MODE(3) | TMR_SCTRL_IEFIE;  // capture on both edges of the channel's input
+  ch->CTRL = TMR_CTRL_CM(1) | TMR_CTRL_PCS(8 + capturePrescale) | TMR_CTRL_SCS(in->channel);  // free-running count
+  enbl = &tmrModule[in->module]->CH[0].ENBL;
+  *enbl |= (1 << in->channel);
+  if (in->selectInput != NULL)
+    *in->selectInput = 1;   // QuadTimer input from this pad (ALT1)
+  *portConfigRegister(in->pin) = muxQuadTimer;
+  slotInput[slot] = i;
+  slotButton[slot] = btn;
+  attachInterruptVector(tmrIrq[in->module], isrs[in->module]);
+  NVIC_SET_PRIORITY(tmrIrq[in->module], 32);
+  NVIC_ENABLE_IRQ(tmrIrq[in->module]);
+#else
+  slotButton[slot] = btn;
+#endif
+  return (slot);
+}
+
+
+/* pushButtonCaptureClass::detach()
+    Stops capturing the edges of a pushbutton and frees its slot. On the target, the pin is switched back to GPIO.
+    Parameters:
+      pushButtonClass *btn: pushbutton previously attached with attach()
+    Returns: None
+*/
+PB_FLASHMEM void pushButtonCaptureClass::detach(pushButtonClass *btn) {
+  uint8_t slot;
+#ifndef PB_MOCK_CAPTURE
+  const pbCaptureInput *in;
+  uint8_t s;
+  bool moduleUsed;
+#endif
+
+  for (slot = 0; slot < captureMaxButtons; slot++) {
+    if (slotButton[slot] != btn)
+      continue;
+#ifndef PB_MOCK_CAPTURE
+    in = &captureInputs[slotInput[slot]];
+    tmrModule[in->module]->CH[in->channel].SCTRL = 0;   // disable capture and its interrupt
+    tmrModule[in->module]->CH[in->channel].CTRL = 0;
+    *portConfigRegister(in->pin) = muxGpio;
+    slotButton[slot] = NULL;
+    moduleUsed = false;
+    for (s = 0; s < captureMaxButtons; s++) {
+      if ((slotButton[s] != NULL) && (captureInputs[slotInput[s]].module == in->module))
+        moduleUsed = true;
+    }
+    if (!moduleUsed)
+      NVIC_DISABLE_IRQ(tmrIrq[in->module]);
+#else
+    slotButton[slot] = NULL;
+#endif
+  }
+}
+
+
+/* pushButtonCaptureClass::relocate()
+    Passes the capture slot of a pushbutton to a copy of it at another address, e.g. when a pool moves its pushbuttons
+      (see pushButtonPoolClass::remove()). Must be called with interrupts disabled, together with the copy, so that no
+      edge is captured into the old object after it was copied.
+    Parameters:
+      pushButtonClass *from: pushbutton previously attached with attach()
+      pushButtonClass *to: copy of the pushbutton that receives further edges
+    Returns: None
+*/
+PB_FLASHMEM void pushButtonCaptureClass::relocate(pushButtonClass *from, pushButtonClass *to) {
+  uint8_t slot;
+
+  for (slot = 0; slot < captureMaxButtons; slot++) {
+    if (slotButton[slot] == from)
+      slotButton[slot] = to;
+  }
+}
+
+
+/* pushButtonCaptureClass::setBusClock()
+    Sets the length of a QuadTimer tick from the IP bus clock, which depends on the CPU speed. Called by attach() with
+      F_BUS_ACTUAL; call again after changing the CPU speed while pushbuttons are attached.
+    Parameters:
+      uint32_t busHz: IP bus clock (Hz)
+    Returns: None
+*/
+PB_FLASHMEM void pushButtonCaptureClass::setBusClock(uint32_t busHz) {
+  tickScale = (uint32_t) (((uint64_t) 1000000 << (16 + capturePrescale)) / busHz);
+}
+
+
+/* pushButtonCaptureClass::edgeMicros()
+    Converts a captured QuadTimer count to micros() time, from the current count and time. The edge must have been
+      captured less than one counter period (65536 ticks, 55.9 ms with the 150 MHz bus clock) earlier.
+    Parameters:
+      uint16_t captured: counter value captured at the edge
+      uint16_t counter: counter value at time nowUs
+      uint32_t nowUs: current time (micros())
+    Returns:
+      uint32_t: time of the edge (micros())
+*/
+PB_FASTRUN uint32_t pushButtonCaptureClass::edgeMicros(uint16_t captured, uint16_t counter, uint32_t nowUs) {
+  uint16_t ticks = counter - captured;
+
+  return (nowUs - (uint32_t) ((((uint64_t) ticks * tickScale) + 0x8000) >> 16));   // rounded to the nearest us
+}
+
+
+#ifdef PB_MOCK_CAPTURE
+/* pushButtonCaptureClass::mockEdge()
+    Emulates a captured edge for the pushbutton in a slot.
+    Parameters:
+      uint8_t slot: capture slot number returned by attach()
+      uint8_t level: simulated pin level after the edge (HIGH or LOW)
+      uint32_t timeUs: simulated time of the edge (us)
+    Returns: None
+*/
+void pushButtonCaptureClass::mockEdge(uint8_t slot, uint8_t level, uint32_t timeUs) {
+  if ((slot < captureMaxButtons) && (slotButton[slot] != NULL))
+    slotButton[slot]->captureEdge(level, timeUs);
+}
+#else
+/* pushButtonCaptureClass::service()
+    Passes the captured edges of all slots on a QuadTimer module to their pushbuttons. The capture flag is cleared before
+      the input level is read, so an edge that occurs in between is captured again rather than lost. Called from the
+      module's interrupt.
+    Parameters:
+      uint8_t module: QuadTimer module (0-2 for TMR1-3)
+    Returns: None
+*/
+PB_FASTRUN void pushButtonCaptureClass::service(uint8_t module) {
+  IMXRT_TMR_CH_t *ch;
+  uint16_t captured;
+  uint8_t slot, level;
+
+  for (slot = 0; slot < captureMaxButtons; slot++) {
+    if ((slotButton[slot] == NULL) || (captureInputs[slotInput[slot]].module != module))
+      continue;
+    ch = &tmrModule[module]->CH[captureInputs[slotInput[slot]].channel];
+    if (!(ch->SCTRL & TMR_SCTRL_IEF))
+      continue;
+    captured = ch->CAPT;
+    ch->SCTRL &= ~TMR_SCTRL_IEF;  // re-arm capture
+    level = (ch->SCTRL & TMR_SCTRL_INPUT) ? HIGH : LOW;
+    slotButton[slot]->captureEdge(level, edgeMicros(captured, ch->CNTR, micros()));
+  }
+  asm("DSB");
+}
+
+  // QuadTimer interrupts, one per module (attachInterruptVector() does not pass a parameter)
+PB_FASTRUN void pushButtonCaptureClass::isrTmr1() { service(0); }
+PB_FASTRUN void pushButtonCaptureClass::isrTmr2() { service(1); }
+PB_FASTRUN void pushButtonCaptureClass::isrTmr3() { service(2); }
+#endif
+
+#endif
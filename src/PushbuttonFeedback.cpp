@@ -0,0 +1,233 @@
+/* PUSHBUTTONFEEDBACK.CPP
+    Implements a pushButtonFeedbackClass that maps pushbutton states to output patterns (e.g. LED on while pressed, 
+      blinking while waiting for a possible double-tap) and writes them in the same scan as the pushbutton update, so that
+      the press-to-light latency doesn't depend on how often the application polls for events.
+*/
+
+#include <Arduino.h>
+#include "PushbuttonFeedback.h"
+
+
+/* pushButtonFeedbackClass::init()
+    Initializes the feedback outputs with no outputs assigned and the default patterns: FB_ON while pressed (WAIT_LONG, 
+      WAIT_INACTIVE and WAIT_DOUBLE_HOLD), FB_BLINK while waiting for a possible double-tap, FB_OFF otherwise.
+    Parameters:
+      fbBackendEnum be: output backend (see fbBackendEnum in PushbuttonFeedback.h)
+      void (*fn)(uint32_t bits): output function for FB_CALLBACK (otherwise NULL)
+    Returns: None
+*/
+PB_FLASHMEM void pushButtonFeedbackClass::init(fbBackendEnum be, void (*fn)(uint32_t bits)) {
+  uint8_t i;
+
+  backend = be;
+  writeFn = fn;
+  setReg = NULL;
+  clearReg = NULL;
+  allMask = 0;
+  lastBits = 0;
+  for (i = 0; i < fbMaxOutputs; i++) {
+    outMask[i] = 0;
+    curPattern[i] = FB_OFF;
+    patternStart[i] = 0;
+#ifdef PB_MOCK_FEEDBACK
+    mockChange[i] = 0;
+#endif
+  }
+  pattern[RDY] = FB_OFF;
+  pattern[WAIT_LONG] = FB_ON;
+  pattern[WAIT_DOUBLE] = FB_BLINK;
+  pattern[WAIT_INACTIVE] = FB_ON;
+  pattern[WAIT_DOUBLE_HOLD] = FB_ON;
+}
+
+
+/* pushButtonFeedbackClass::setOutput()
+    Assigns an output to a pushbutton.
+    Parameters:
+      uint8_t index: index of the pushbutton in the bank (see pushButtonBankClass::getButton())
+      uint8_t outPin: FB_PORT: output pin number, configured as an output (all outputs must be on the same GPIO port);
+        FB_CALLBACK and FB_MOCK: bit number (0-31) in the output word
+    Returns: None
+*/
+PB_FLASHMEM void pushButtonFeedbackClass::setOutput(uint8_t index, uint8_t outPin) {
+  if (index >= fbMaxOutputs)
+    return;
+  if (backend == FB_PORT) {
+    pinMode(outPin, OUTPUT);
+    setReg = portSetRegister(outPin);
+    clearReg = portClearRegister(outPin);
+    outMask[index] = digitalPinToBitMask(outPin);
+    *clearReg = outMask[index];   // start with output off
+  }
+  else
+    outMask[index] = ((uint32_t) 1 << (outPin & 31));
+  updateAllMask();   // the index may have had another output
+}
+
+
+/* pushButtonFeedbackClass::clearOutput()
+    Removes the output assignment of a pushbutton (e.g. when it is removed from a pool). FB_PORT: the output pin is turned
+      off now (unless another pushbutton uses it) and no longer written by apply(), so it can be reused; otherwise the 
+      output is turned off by the next apply() if it is on.
+    Parameters:
+      uint8_t index: index of the pushbutton in the bank
+    Returns: None
+*/
+PB_FLASHMEM void pushButtonFeedbackClass::clearOutput(uint8_t index) {
+  uint32_t mask;
+
+  if (index >= fbMaxOutputs)
+    return;
+  mask = outMask[index];
+  outMask[index] = 0;
+  curPattern[index] = FB_OFF;
+  updateAllMask();
+  mask &= ~allMask;   // bits no longer used by any output
+  if ((backend == FB_PORT) && (clearReg != NULL) && (mask != 0)) {
+    *clearReg = mask;
+    lastBits &= ~mask;
+  }
+}
+
+
+/* pushButtonFeedbackClass::moveOutput()
+    Moves the output assignment and pattern timing of a pushbutton to another bank index, e.g. when a pool moves the
+      pushbutton to another slot (see pushButtonPoolClass::remove()). The output at the destination index is replaced,
+      and the source index is left without an output.
+    Parameters:
+      uint8_t from: index of the pushbutton in the bank before the move
+      uint8_t to: index of the pushbutton in the bank after the move
+    Returns: None
+*/
+PB_FLASHMEM void pushButtonFeedbackClass::moveOutput(uint8_t from, uint8_t to) {
+  if ((from >= fbMaxOutputs) || (to >= fbMaxOutputs) || (from == to))
+    return;
+  clearOutput(to);
+  outMask[to] = outMask[from];
+  curPattern[to] = curPattern[from];
+  patternStart[to] = patternStart[from];
+#ifdef PB_MOCK_FEEDBACK
+  mockChange[to] = mockChange[from];
+#endif
+  clearOutput(from);
+}
+
+
+/* pushButtonFeedbackClass::updateAllMask()
+    Recomputes the mask of all output bits written by apply() (FB_PORT), after outputs were assigned or removed.
+    Parameters: None
+    Returns: None
+*/
+PB_FLASHMEM void pushButtonFeedbackClass::updateAllMask() {
+  uint8_t i;
+
+  allMask = 0;
+  for (i = 0; i < fbMaxOutputs; i++)
+    allMask |= outMask[i];
+}
+
+
+/* pushButtonFeedbackClass::setPattern()
+    Changes the pattern shown while a pushbutton is in a given state.
+    Parameters:
+      stateEnum st: pushbutton state
+      fbPatternEnum pat: output pattern
+    Returns: None
+*/
+PB_FLASHMEM void pushButtonFeedbackClass::setPattern(stateEnum st, fbPatternEnum pat) {
+  if (st <= WAIT_DOUBLE_HOLD)
+    pattern[st] = pat;
+}
+
+
+/* pushButtonFeedbackClass::apply()
+    Evaluates the pattern of each output from its pushbutton's state and writes the outputs that changed. Called by the 
+      bank at the end of each update.
+    Parameters:
+      pushButtonBankClass *bank: bank whose pushbuttons drive the outputs
+      uint32_t now: time of the update (ms)
+    Returns: None
+*/
+PB_FASTRUN void pushButtonFeedbackClass::apply(pushButtonBankClass *bank, uint32_t now) {
+  pushButtonClass *btn;
+  uint32_t bits = 0, changed, t;
+  uint8_t i, n, pat;
+  bool on;
+
+  n = bank->getCount();
+  if (n > fbMaxOutputs)
+    n = fbMaxOutputs;
+  for (i = 0; i < n; i++) {
+    if (outMask[i] == 0)
+      continue;
+    btn = bank->getButton(i);
+    pat = pattern[btn->getState()];
+    if (pat != curPattern[i]) {   // start blink/PWM cycle from the state change
+      curPattern[i] = pat;
+      patternStart[i] = now;
+    }
+    t = now - patternStart[i];
+    switch (pat) {
+      case FB_ON:
+        on = true;
+      break;
+      case FB_BLINK:
+        on = ((t % fbBlinkPeriod) < (fbBlinkPeriod / 2));
+      break;
+      case FB_RAMP:   // software PWM, duty cycle from 1/fbPwmPeriod to 100% as the press approaches a long press
+        on = ((t % fbPwmPeriod) <= ((btn->holdProgress(now) * (fbPwmPeriod - 1)) / 255));
+      break;
+      default:
+        on = false;
+      break;
+    }
+    if (on)
+      bits |= outMask[i];
+  }
+  changed = bits ^ lastBits;
+  if (changed == 0)
+    return;
+  lastBits = bits;
+  switch (backend) {
+    case FB_PORT:
+      if (setReg != NULL) {
+        *setReg = bits & allMask;
+        *clearReg = ~bits & allMask;
+      }
+    break;
+    case FB_CALLBACK:
+      if (writeFn != NULL)
+        writeFn(bits);
+    break;
+    default:
+#ifdef PB_MOCK_FEEDBACK
+      for (i = 0; i < fbMaxOutputs; i++) {
+        if (changed & outMask[i])
+          mockChange[i] = now;
+      }
+#endif
+    break;
+  }
+}
+
+
+#ifdef PB_MOCK_FEEDBACK
+/* pushButtonFeedbackClass::mockLastChange()
+    Returns the time of the last change of an output (FB_MOCK backend), e.g. to measure press-to-light latency.
+    Parameters:
+      uint8_t index: index of the pushbutton in the bank
+    Returns:
+      uint32_t: time of the last change (ms)
+*/
+uint32_t pushButtonFeedbackClass::mockLastChange(uint8_t index) {
+  return ((index < fbMaxOutputs) ? mockChange[index] : 0);
+}
+
+
+/* pushButtonFeedbackClass::mockBits()
+    Returns the current output bits (FB_MOCK backend).
+*/
+uint32_t pushButtonFeedbackClass::mockBits() {
+  return (lastBits);
+}
+#endif
@@ -0,0 +1,79 @@
+/* PUSHBUTTONHOST.CPP
+    Implements a C interface to the pushbutton engine for host builds (defined with PB_HOST_API), so that recorded switch
+      captures can be analyzed and timing parameters swept at native speed from other languages (e.g. Python/NumPy). 
+      Samples are run through pushButtonClass::updateSample(), the same batch path used by the bank and sampler.
+*/
+
+#include <Arduino.h>
+#include "PushbuttonHost.h"
+
+#ifdef PB_HOST_API
+
+static_assert((offsetof(pbEventRecord, time) == 0) && (offsetof(pbEventRecord, pin) == 4) && 
+  (offsetof(pbEventRecord, event) == 8) && (offsetof(pbEventRecord, count) == 12) && (sizeof(pbEventRecord) == 16) &&
+  (sizeof(eventEnum) == 4), "pbEventRecord layout doesn't match the documented NumPy dtype");
+
+
+/* pbHostRun()
+    Runs a capture through a fresh set of pushbuttons with the given settings, and returns the detected events.
+    Parameters:
+      const uint32_t *samples: GPIO port samples (bit n is the level of the pushbutton with pin n)
+      const uint32_t *times: time of each sample (ms), non-decreasing; samples need not be evenly spaced
+      uint32_t count: number of elements in samples[] and times[]
+      const uint8_t *pins: bit position in samples (0-31) of each pushbutton, also reported as the event's pin
+      uint8_t numPins: number of elements in pins[] (max hostMaxButtons)
+      uint8_t actLevel, int eventSel: see pushButtonClass::init() (the same for all pushbuttons)
+      uint16_t dbPeriod, doubleDly, longDur: see pushButtonClass::setDelays() (0 keeps the default)
+      pbEventRecord *events: receives the detected events, in order
+      uint32_t maxEvents: number of elements in events[]; further events are counted but not stored
+    Returns:
+      uint32_t: number of events detected (may exceed maxEvents); 0 if numPins or a bit position is out of range
+*/
+uint32_t pbHostRun(const uint32_t *samples, const uint32_t *times, uint32_t count, 
+    const uint8_t *pins, uint8_t numPins, uint8_t actLevel, int eventSel, 
+    uint16_t dbPeriod, uint16_t doubleDly, uint16_t longDur, 
+    pbEventRecord *events, uint32_t maxEvents) {
+  pushButtonClass buttons[hostMaxButtons];
+  uint32_t numEvents = 0;
+  uint32_t i;
+  uint8_t b;
+  eventEnum ev;
+
+  if (numPins > hostMaxButtons)
+    return (0);
+  for (b = 0; b < numPins; b++) {
+    if (pins[b] >= 32)
+      return (0);
+  }
+  for (b = 0; b < numPins; b++) {
+    buttons[b].init(pins[b], actLevel, false, eventSel);
+    buttons[b].setSampleMask(1u << pins[b]);  // bit position, not a board pin number
+    buttons[b].setDelays(dbPeriod, doubleDly, longDur);
+  }
+  for (i = 0; i < count; i++) {
+    for (b = 0; b < numPins; b++) {
+      buttons[b].updateSample(samples[i], times[i]);
+      ev = buttons[b].getEvent();
+      if (ev != NO_PRESS) {
+        if (numEvents < maxEvents) {
+          events[numEvents].time = times[i];
+          events[numEvents].pin = pins[b];
+          events[numEvents].event = ev;
+          events[numEvents].count = 1;
+        }
+        numEvents++;
+      }
+    }
+  }
+  return (numEvents);
+}
+
+
+/* pbHostEventSize()
+    Returns sizeof(pbEventRecord), so that callers can check their event array layout at run time.
+*/
+uint32_t pbHostEventSize() {
+  return (sizeof(pbEventRecord));
+}
+
+#endif
@@ -0,0 +1,194 @@
+/* PUSHBUTTONPOOL.CPP
+    Implements a pushButtonPoolClass for panels where button modules are attached and detached at runtime (e.g. through
+      I/O expanders). Pushbuttons are allocated from a fixed pool with O(1) add and remove; removal moves the last active
+      pushbutton into the vacated slot, so the active pushbuttons stay packed for scanning, and moves its feedback output
+      and capture slot with it.
+*/
+
+#include <Arduino.h>
+#include "PushbuttonPool.h"
+
+
+/* pushButtonPoolClass::init()
+    Initializes the pool with no active pushbuttons.
+    Parameters: None
+    Returns: None
+*/
+PB_FLASHMEM void pushButtonPoolClass::init() {
+  uint8_t i;
+
+  for (i = 0; i < poolSize; i++)
+    freeHandles[i] = poolSize - 1 - i;    // handle 0 is allocated first
+  numFree = poolSize;
+  numActive = 0;
+  feedback = NULL;
+  bank.init(buttons, 0);
+}
+
+
+/* pushButtonPoolClass::add()
+    Allocates and initializes a pushbutton (see pushButtonClass::init()).
+    Parameters:
+      uint8_t module: module number, used to remove a group of pushbuttons with removeModule()
+      uint8_t ioPinNum, uint8_t actLevel, bool pullup, int eventSel: see pushButtonClass::init()
+    Returns:
+      int8_t: handle of the new pushbutton; -1 if the pool is full
+*/
+int8_t pushButtonPoolClass::add(uint8_t module, uint8_t ioPinNum, uint8_t actLevel, bool pullup, int eventSel) {
+  uint8_t handle;
+
+  if (numFree == 0)
+    return (-1);
+  handle = freeHandles[--numFree];
+  buttons[numActive].init(ioPinNum, actLevel, pullup, eventSel);
+  moduleOf[numActive] = module;
+  handleOf[numActive] = handle;
+  slotOf[handle] = numActive;
+  noInterrupts();   // the bank may be updated from an interrupt (e.g. by the sampler)
+  numActive++;
+  bank.setCount(numActive);
+  interrupts();
+  return (handle);
+}
+
+
+/* pushButtonPoolClass::remove()
+    Frees a pushbutton: releases its capture slot, event ring, feedback output and pin pullup. The last active 
+      pushbutton is moved into its slot, together with its capture slot and feedback output.
+    Parameters:
+      uint8_t handle: handle returned by add()
+    Returns: None
+*/
+void pushButtonPoolClass::remove(uint8_t handle) {
+  uint8_t slot, last;
+
+  if ((handle >= poolSize) || (slotOf[handle] >= numActive) || (handleOf[slotOf[handle]] != handle))  // not active
+    return;
+  slot = slotOf[handle];
+  last = numActive - 1;
+#ifdef PB_EDGE_CAPTURE
+  pushButtonCaptureClass::detach(&buttons[slot]);
+#endif
+  buttons[slot].attachRing(NULL);
+  pinMode(buttons[slot].pNum, INPUT);
+  if (feedback != NULL)
+    feedback->clearOutput(slot);
+  noInterrupts();   // no edge may be captured into the old copy, and no bank update may see a partial move
+  if (slot != last) {   // fill the hole with the last active pushbutton
+    buttons[slot] = buttons[last];
+#ifdef PB_EDGE_CAPTURE
+    pushButtonCaptureClass::relocate(&buttons[last], &buttons[slot]);
+#endif
+    if (feedback != NULL)
+      feedback->moveOutput(last, slot);
+    moduleOf[slot] = moduleOf[last];
+    handleOf[slot] = handleOf[last];
+    slotOf[handleOf[slot]] = slot;
+  }
+  handleOf[last] = poolSize;  // mark slot as unused
+  numActive--;
+  bank.setCount(numActive);
+  interrupts();
+  freeHandles[numFree++] = handle;
+}
+
+
+/* pushButtonPoolClass::removeModule()
+    Frees all pushbuttons of a module (e.g. when the module is detached).
+    Parameters:
+      uint8_t module: module number passed to add()
+    Returns:
+      uint8_t: number of pushbuttons removed
+*/
+uint8_t pushButtonPoolClass::removeModule(uint8_t module) {
+  uint8_t i, n = 0;
+
+  for (i = numActive; i > 0; i--) {   // backwards, so that moved pushbuttons have already been checked
+    if (moduleOf[i - 1] == module) {
+      remove(handleOf[i - 1]);
+      n++;
+    }
+  }
+  return (n);
+}
+
+
+/* pushButtonPoolClass::get()
+    Returns an active pushbutton, e.g. to read its events. The pointer is valid until the next call to remove() or 
+      removeModule().
+    Parameters:
+      uint8_t handle: handle returned by add()
+    Returns:
+      pushButtonClass *: pushbutton, or NULL if the handle is not active
+*/
+pushButtonClass *pushButtonPoolClass::get(uint8_t handle) {
+  if ((handle >= poolSize) || (slotOf[handle] >= numActive) || (handleOf[slotOf[handle]] != handle))
+    return (NULL);
+  return (&buttons[slotOf[handle]]);
+}
+
+
+/* pushButtonPoolClass::attachFeedback()
+    Attaches feedback outputs, which are then driven from the active pushbuttons by update() and by the bank returned
+      by getBank(). Outputs must be assigned with setOutput(), so that they follow their pushbuttons when others are
+      removed.
+    Parameters:
+      pushButtonFeedbackClass *fb: feedback outputs, previously initialized with init(); NULL to detach
+    Returns: None
+*/
+PB_FLASHMEM void pushButtonPoolClass::attachFeedback(pushButtonFeedbackClass *fb) {
+  feedback = fb;
+  bank.attachFeedback(fb);
+}
+
+
+/* pushButtonPoolClass::setOutput()
+    Assigns a feedback output to an active pushbutton (see pushButtonFeedbackClass::setOutput()).
+    Parameters:
+      uint8_t handle: handle returned by add()
+      uint8_t outPin: see pushButtonFeedbackClass::setOutput()
+    Returns: None
+*/
+PB_FLASHMEM void pushButtonPoolClass::setOutput(uint8_t handle, uint8_t outPin) {
+  if ((feedback == NULL) || (get(handle) == NULL))
+    return;
+  feedback->setOutput(slotOf[handle], outPin);
+}
+
+
+/* pushButtonPoolClass::getCount()
+    Returns the number of active pushbuttons.
+*/
+uint8_t pushButtonPoolClass::getCount() {
+  return (numActive);
+}
+
+
+/* pushButtonPoolClass::getBank()
+    Returns a bank containing the active pushbuttons (e.g. for port-wide or block updates, or simulation). The pointer
+      stays valid for the life of the pool: add() and remove() resize the bank, so that it always contains exactly the
+      active pushbuttons. The bank's shared port (getPort()) can change when pushbuttons are added, so users that set up
+      sampling from it (e.g. pushButtonSamplerClass::begin()) must be restarted after adding a pushbutton on another port.
+    Parameters: None
+    Returns:
+      pushButtonBankClass *: bank of active pushbuttons
+*/
+pushButtonBankClass *pushButtonPoolClass::getBank() {
+  return (&bank);
+}
+
+
+/* pushButtonPoolClass::update()
+    Called periodically to update all active pushbuttons (see pushButtonClass::update()), then the feedback outputs if
+      attached.
+    Parameters: None
+    Returns: None
+*/
+PB_FASTRUN void pushButtonPoolClass::update() {
+  uint8_t i;
+
+  for (i = 0; i < numActive; i++)
+    buttons[i].update();
+  if (feedback != NULL)
+    feedback->apply(&bank, millis());
+}
@@ -0,0 +1,188 @@
+/* PUSHBUTTONRING.CPP
+    Implements a pushButtonRingClass that delivers every pushbutton event to multiple consumers (e.g. UI, logger and HID 
+      output). Events are written once into a fixed ring; each subscriber has an independent read cursor and reads events in
+      place, without copying.
+*/
+
+#include <Arduino.h>
+#include "PushbuttonRing.h"
+
+
+/* pushButtonRingClass::init()
+    Initializes the ring with no events and no subscribers.
+    Parameters: None
+    Returns: None
+*/
+PB_FLASHMEM void pushButtonRingClass::init() {
+  head = 0;
+  numSubs = 0;
+  coalesceThreshold = 0;
+  publishedCount = 0;
+  coalescedCount = 0;
+}
+
+
+/* pushButtonRingClass::subscribe()
+    Adds a subscriber. The new subscriber sees only events published after this call.
+    Parameters: None
+    Returns:
+      int8_t: subscriber number, used with read(), available() and overruns(); -1 if ringMaxSubs has been reached
+*/
+PB_FLASHMEM int8_t pushButtonRingClass::subscribe() {
+  if (numSubs >= ringMaxSubs)
+    return (-1);
+  cursor[numSubs] = head;
+  overrunCount[numSubs] = 0;
+  return (numSubs++);
+}
+
+
+/* pushButtonRingClass::publish()
+    Writes an event to the ring, overwriting the oldest event if the ring is full. Normally called by 
+      pushButtonClass::update(). If coalescing applies (see setCoalescing()), the count of the newest record is incremented
+      instead; the record keeps the time of the first merged event.
+    Parameters:
+      uint8_t pin: pin number of the pushbutton
+      eventEnum ev: detected event
+      uint32_t time: time of the event (ms)
+    Returns: None
+*/
+PB_FASTRUN void pushButtonRingClass::publish(uint8_t pin, eventEnum ev, uint32_t time) {
+  pbEventRecord *r;
+  uint32_t minLag, maxLag;
+
+  publishedCount++;
+  if ((coalesceThreshold > 0) && (head > 0)) {
+    getBacklog(minLag, maxLag);
+    if ((maxLag >= coalesceThreshold) && (minLag > 0)) {  // consumers are behind, and none has read the newest record
+      r = &buf[(head - 1) & (ringSize - 1)];  // newest record
+      if ((r->pin == pin) && (r->event == ev) && (r->count < 255)) {
+        r->count++;
+        coalescedCount++;
+        return;
+      }
+    }
+  }
+  r = &buf[head & (ringSize - 1)];
+  r->time = time;
+  r->pin = pin;
+  r->event = ev;
+  r->count = 1;
+  head++;
+}
+
+
+/* pushButtonRingClass::read()
+    Returns the next unread event for a subscriber and advances its cursor. If the subscriber has fallen more than ringSize
+      events behind, the missed events are added to its overrun count and reading resumes with the oldest event still in 
+      the ring.
+    The event is not copied: its slot is reused after (ringSize - n) more events have been published, where n is the 
+      number of unread events before the call (see available()). In particular, when the subscriber was a full ring behind
+      (including just after an overrun), the next publish() overwrites it, so copy the event first if events can be 
+      published while it is in use (e.g. from an interrupt).
+    Parameters:
+      uint8_t sub: subscriber number returned by subscribe()
+    Returns:
+      const pbEventRecord *: next event, or NULL if there are no unread events
+*/
+const pbEventRecord *pushButtonRingClass::read(uint8_t sub) {
+  uint32_t lag;
+
+  if (sub >= numSubs)
+    return (NULL);
+  lag = head - cursor[sub];
+  if (lag == 0)   // no unread events
+    return (NULL);
+  if (lag > ringSize) {  // oldest unread events have been overwritten
+    overrunCount[sub] += (lag - ringSize);
+    cursor[sub] = head - ringSize;
+  }
+  return (&buf[cursor[sub]++ & (ringSize - 1)]);
+}
+
+
+/* pushButtonRingClass::available()
+    Returns the number of unread events for a subscriber (max ringSize).
+    Parameters:
+      uint8_t sub: subscriber number returned by subscribe()
+    Returns:
+      uint8_t: number of events that can be read with read()
+*/
+uint8_t pushButtonRingClass::available(uint8_t sub) {
+  uint32_t lag;
+
+  if (sub >= numSubs)
+    return (0);
+  lag = head - cursor[sub];
+  return ((lag > ringSize) ? ringSize : lag);
+}
+
+
+/* pushButtonRingClass::overruns()
+    Returns the number of events that a subscriber missed because it did not read them in time.
+    Parameters:
+      uint8_t sub: subscriber number returned by subscribe()
+    Returns:
+      uint32_t: total number of missed events
+*/
+uint32_t pushButtonRingClass::overruns(uint8_t sub) {
+  if (sub >= numSubs)
+    return (0);
+  return (overrunCount[sub]);
+}
+
+
+/* pushButtonRingClass::setCoalescing()
+    Enables or disables event coalescing. While the slowest subscriber has at least "threshold" unread events, an event that
+      is identical (same pushbutton and event) to the newest event is merged into it, provided that no subscriber has read
+      the newest event yet; every subscriber therefore still sees every event, either as a record or in a count. This keeps
+      the ring from overrunning when consumers are busy, e.g. during a display refresh.
+    Parameters:
+      uint8_t threshold: min backlog (unread events) to enable coalescing; 0 disables coalescing (default)
+    Returns: None
+*/
+PB_FLASHMEM void pushButtonRingClass::setCoalescing(uint8_t threshold) {
+  coalesceThreshold = threshold;
+}
+
+
+/* pushButtonRingClass::published()
+    Returns the total number of events published to the ring, including events that were coalesced.
+    Parameters: None
+    Returns:
+      uint32_t: number of events published
+*/
+uint32_t pushButtonRingClass::published() {
+  return (publishedCount);
+}
+
+
+/* pushButtonRingClass::coalesced()
+    Returns the number of events that were merged into a previous record. The coalescing rate is coalesced() / published().
+    Parameters: None
+    Returns:
+      uint32_t: number of coalesced events
+*/
+uint32_t pushButtonRingClass::coalesced() {
+  return (coalescedCount);
+}
+
+
+/* pushButtonRingClass::getBacklog()
+    Finds the number of unread events of the fastest and slowest subscribers (both 0 if there are no subscribers). A 
+      subscriber has read the newest event only if its backlog is 0.
+*/
+void pushButtonRingClass::getBacklog(uint32_t &minLag, uint32_t &maxLag) {
+  uint32_t lag;
+  uint8_t i;
+
+  minLag = 0;
+  maxLag = 0;
+  for (i = 0; i < numSubs; i++) {
+    lag = head - cursor[i];
+    if ((i == 0) || (lag < minLag))
+      minLag = lag;
+    if (lag > maxLag)
+      maxLag = lag;
+  }
+}
@@ -0,0 +1,177 @@
+/* PUSHBUTTONSAMPLER.CPP
+    Implements a pushButtonSamplerClass that samples the GPIO port of a pushbutton bank using a PIT timer and DMA (Teensy 4.x),
+      so that sampling has no jitter and no CPU cost. The bank processes each completed half of a ping-pong buffer in one 
+      batch (see pushButtonBankClass::updateBlock()).
+    The DMA controller can't read the fast GPIO ports (GPIO6-9) normally used by Teensy 4.x, so the bank's pins are switched
+      to the corresponding standard ports (GPIO1-4), which have the same bit layout. digitalReadFast() can't be used with 
+      these pins while the sampler is running.
+*/
+
+#include <Arduino.h>
+#include "PushbuttonSampler.h"
+
+#ifndef PB_MOCK_SAMPLER
+pushButtonSamplerClass *pushButtonSamplerClass::activeSampler = NULL;
+
+  // Standard GPIO port input registers corresponding to fast ports GPIO6-9
+static volatile uint32_t * const stdPortIn[4] = {&GPIO1_PSR, &GPIO2_PSR, &GPIO3_PSR, &GPIO4_PSR};
+#endif
+
+
+/* pushButtonSamplerClass::begin()
+    Starts sampling the bank's GPIO port. Only one sampler can be active at a time.
+    Parameters:
+      pushButtonBankClass *bnk: bank, previously initialized with init(). All pushbuttons must be on the same port.
+      uint16_t periodMs: interval between samples (ms), at least 1; should be less than the debounce period
+    Returns:
+      bool: true if sampling was started; false if periodMs is 0, the bank is empty or its pushbuttons are on 
+        different ports, or no suitable DMA channel is available
+*/
+PB_FLASHMEM bool pushButtonSamplerClass::begin(pushButtonBankClass *bnk, uint16_t periodMs) {
+  if ((periodMs == 0) || (bnk->getPortMask() == 0))   // PIT can't count 0 ms; nothing to sample
+    return (false);
+  bank = bnk;
+  samplePeriod = periodMs;
+  readyMask = 0;
+  overrunCount = 0;
+  fillHalf = 0;
+  pollHalf = 0;
+#ifdef PB_MOCK_SAMPLER
+  mockIndex = 0;
+  return (bank->getPort() != NULL);
+#else
+  volatile uint32_t *fastPort = bank->getPort();
+  volatile uint32_t *mux;
+  uint8_t portNum;
+
+  if ((fastPort == NULL) || (activeSampler != NULL))
+    return (false);
+  portNum = ((uint32_t) fastPort - IMXRT_GPIO6_ADDRESS) >> 14;  // 0-3 for GPIO6-9
+  if (portNum > 3)
+    return (false);
+  dma.begin(true);
+  if (dma.channel > 3) {  // periodic triggering only works with DMA channels 0-3 (paired with PIT channels 0-3)
+    dma.release();
+    return (false);
+  }
+  pitChannel = dma.channel;
+  activeSampler = this;
+  (&IOMUXC_GPR_GPR26)[portNum] &= ~bank->getPortMask();   // switch pins from fast GPIO6-9 to standard GPIO1-4
+
+  dma.source(*stdPortIn[portNum]);
+  dma.destinationBuffer(buf, sizeof(buf));   // circular: wraps to the start of buf after the last element
+  dma.interruptAtHalf();
+  dma.interruptAtCompletion();
+  dma.attachInterrupt(isr);
+  mux = &DMAMUX_CHCFG0 + dma.channel;
+  *mux = 0;
+  *mux = DMAMUX_CHCFG_ENBL | DMAMUX_CHCFG_TRIG | DMAMUX_CHCFG_A_ON;   // always-on request, gated by PIT channel
+  dma.enable();
+
+  CCM_CCGR1 |= CCM_CCGR1_PIT(CCM_CCGR_ON);
+  PIT_MCR = 0;
+  IMXRT_PIT_CHANNELS[pitChannel].TCTRL = 0;
+  IMXRT_PIT_CHANNELS[pitChannel].LDVAL = (24000 * (uint32_t) periodMs) - 1;   // 24 MHz PIT clock
+  IMXRT_PIT_CHANNELS[pitChannel].TCTRL = PIT_TCTRL_TEN;
+  return (true);
+#endif
+}
+
+
+/* pushButtonSamplerClass::end()
+    Stops sampling. The bank's pins are switched back to the fast GPIO port.
+    Parameters: None
+    Returns: None
+*/
+PB_FLASHMEM void pushButtonSamplerClass::end() {
+#ifndef PB_MOCK_SAMPLER
+  if (activeSampler != this)
+    return;
+  IMXRT_PIT_CHANNELS[pitChannel].TCTRL = 0;
+  dma.disable();
+  dma.detachInterrupt();
+  dma.release();
+  (&IOMUXC_GPR_GPR26)[((uint32_t) bank->getPort() - IMXRT_GPIO6_ADDRESS) >> 14] |= bank->getPortMask();
+  activeSampler = NULL;
+#endif
+}
+
+
+/* pushButtonSamplerClass::poll()
+    Called periodically (at least once per samplerHalfSize samples) to process completed half-buffers with the bank's
+      updateBlock(). 
+    Parameters: None
+    Returns:
+      uint8_t: number of half-buffers processed (0-2)
+*/
+PB_FASTRUN uint8_t pushButtonSamplerClass::poll() {
+  uint8_t n = 0;
+  uint32_t t;
+
+  while (readyMask & (1 << pollHalf)) {
+    noInterrupts();
+    t = halfTime[pollHalf];
+    interrupts();
+    bank->updateBlock(&buf[pollHalf * samplerHalfSize], samplerHalfSize, samplePeriod, t);
+    noInterrupts();
+    readyMask &= ~(1 << pollHalf);
+    interrupts();
+    pollHalf ^= 1;
+    n++;
+  }
+  return (n);
+}
+
+
+/* pushButtonSamplerClass::overruns()
+    Returns the number of half-buffers that were overwritten by DMA before poll() processed them.
+    Parameters: None
+    Returns:
+      uint32_t: number of overruns
+*/
+uint32_t pushButtonSamplerClass::overruns() {
+  return (overrunCount);
+}
+
+
+/* pushButtonSamplerClass::completeHalf()
+    Marks the half-buffer being filled as ready for poll(). Called from the DMA interrupt (or mockTrigger()).
+    Parameters:
+      uint32_t now: time of the last sample in the half-buffer (ms)
+    Returns: None
+*/
+PB_FASTRUN void pushButtonSamplerClass::completeHalf(uint32_t now) {
+  if (readyMask & (1 << fillHalf))  // previous contents of this half were not processed
+    overrunCount++;
+  halfTime[fillHalf] = now;
+  readyMask |= (1 << fillHalf);
+  fillHalf ^= 1;
+}
+
+
+#ifdef PB_MOCK_SAMPLER
+/* pushButtonSamplerClass::mockTrigger()
+    Emulates one timer-triggered DMA transfer: stores a port sample in the buffer, and completes the half-buffer when it 
+      is full.
+    Parameters:
+      uint32_t portValue: simulated value of the GPIO port input register
+      uint32_t now: simulated time of the sample (ms)
+    Returns: None
+*/
+void pushButtonSamplerClass::mockTrigger(uint32_t portValue, uint32_t now) {
+  buf[mockIndex++] = portValue;
+  if ((mockIndex % samplerHalfSize) == 0)
+    completeHalf(now);
+  if (mockIndex >= (2 * samplerHalfSize))
+    mockIndex = 0;
+}
+#else
+/* pushButtonSamplerClass::isr()
+    DMA interrupt, called when each half of the buffer has been filled.
+*/
+PB_FASTRUN void pushButtonSamplerClass::isr() {
+  activeSampler->dma.clearInterrupt();
+  activeSampler->completeHalf(millis());
+  asm("DSB");
+}
+#endif
@@ -0,0 +1,241 @@
+/* PUSHBUTTONSIM.CPP
+    Implements a pushButtonSimClass that replays long, sparse input traces through a pushbutton bank (e.g. on a host) by 
+      advancing a virtual clock from one input edge or lockout/delay deadline to the next. runFixedTick() replays the same
+      trace with one update per millisecond, as a reference for checking results and measuring the speedup (see steps()).
+*/
+
+#include <Arduino.h>
+#include "PushbuttonSim.h"
+
+
+/* pushButtonSimClass::init()
+    Initializes the simulator. The bank's pushbuttons should be freshly initialized (or restored to the state matching the
+      start of the trace).
+    Parameters:
+      pushButtonBankClass *bnk: bank to simulate
+      const pbTraceEdge *edges: input trace, in time order; the first update is at the time of edges[0] (or 0 if empty)
+      uint32_t numEdges: number of elements in edges[]
+      uint32_t initialSample: port value before the first edge
+    Returns: None
+*/
+void pushButtonSimClass::init(pushButtonBankClass *bnk, const pbTraceEdge *edges, uint32_t numEdges, uint32_t initialSample) {
+  bank = bnk;
+  trace = edges;
+  traceLen = numEdges;
+  nextEdge = 0;
+  sample = initialSample;
+  simTime = (numEdges > 0) ? edges[0].time : 0;
+  idle = false;
+  stepCount = 0;
+  ckpt = NULL;
+  numCkpts = 0;
+}
+
+
+/* pushButtonSimClass::run()
+    Replays the trace up to and including endTime, updating the bank only at input edges and deadlines.
+    Parameters:
+      uint32_t endTime: last time to simulate (ms)
+      pbEventRecord *events: receives the detected events, in order
+      uint32_t maxEvents: number of elements in events[]; further events are not stored
+    Returns:
+      uint32_t: number of events detected
+*/
+uint32_t pushButtonSimClass::run(uint32_t endTime, pbEventRecord *events, uint32_t maxEvents) {
+  uint32_t numEvents = 0;
+  uint32_t t, deadline;
+  bool changed, found;
+  uint8_t i;
+
+  while (true) {
+    if (idle) {  // nothing can happen before the next edge
+      if (nextEdge >= traceLen)
+        break;
+      simTime = trace[nextEdge].time;
+      idle = false;
+    }
+    if (simTime > endTime)
+      break;
+    if ((ckpt != NULL) && (simTime >= nextCkptTime))
+      saveCheckpoint();
+    changed = step(events, maxEvents, numEvents);
+    if (changed) {  // state or lockout changed; the new state may act on the current input immediately
+      simTime++;
+      continue;
+    }
+    found = false;
+    for (i = 0; i < bank->getCount(); i++) {
+      if (bank->getButton(i)->nextDeadline(simTime, t) && (!found || (t < deadline))) {
+        deadline = t;
+        found = true;
+      }
+    }
+    if ((nextEdge < traceLen) && (!found || (trace[nextEdge].time < deadline))) {
+      deadline = trace[nextEdge].time;
+      found = true;
+    }
+    if (found)
+      simTime = deadline;
+    else
+      idle = true;
+  }
+  return (numEvents);
+}
+
+
+/* pushButtonSimClass::runFixedTick()
+    Replays the trace up to and including endTime with one bank update per millisecond (reference implementation).
+    Parameters:
+      uint32_t endTime: last time to simulate (ms)
+      pbEventRecord *events: receives the detected events, in order
+      uint32_t maxEvents: number of elements in events[]; further events are not stored
+    Returns:
+      uint32_t: number of events detected
+*/
+uint32_t pushButtonSimClass::runFixedTick(uint32_t endTime, pbEventRecord *events, uint32_t maxEvents) {
+  uint32_t numEvents = 0;
+
+  for (; simTime <= endTime; simTime++)
+    step(events, maxEvents, numEvents);
+  return (numEvents);
+}
+
+
+/* pushButtonSimClass::setCheckpoints()
+    Enables checkpointing by run(). A checkpoint is saved immediately.
+    Parameters:
+      pbSimCheckpoint *buf: checkpoint buffer
+      uint16_t count: number of elements in buf[] (at least 2)
+      uint32_t interval: initial simulated time between checkpoints (ms)
+    Returns:
+      bool: true if checkpointing is enabled; false if the bank has more than simMaxButtons pushbuttons or count < 2
+*/
+bool pushButtonSimClass::setCheckpoints(pbSimCheckpoint *buf, uint16_t count, uint32_t interval) {
+  if ((bank->getCount() > simMaxButtons) || (count < 2))
+    return (false);
+  ckpt = buf;
+  ckptSize = count;
+  ckptInterval = (interval > 0) ? interval : 1;
+  numCkpts = 0;
+  saveCheckpoint();
+  return (true);
+}
+
+
+/* pushButtonSimClass::seek()
+    Restores the simulation (including the bank's pushbuttons) to the last checkpoint at or before time t. The checkpoint
+      is found by binary search. Checkpoints after it are discarded, since replaying from there will save them again.
+    Parameters:
+      uint32_t t: time (ms)
+    Returns:
+      bool: true if a checkpoint was restored; false if there is no checkpoint at or before t
+*/
+bool pushButtonSimClass::seek(uint32_t t) {
+  uint16_t lo = 0, hi, mid;
+  pbSimCheckpoint *c;
+
+  if ((ckpt == NULL) || (numCkpts == 0) || (ckpt[0].simTime > t))
+    return (false);
+  hi = numCkpts - 1;
+  while (lo < hi) {   // find last checkpoint with simTime <= t
+    mid = (lo + hi + 1) / 2;
+    if (ckpt[mid].simTime <= t)
+      lo = mid;
+    else
+      hi = mid - 1;
+  }
+  c = &ckpt[lo];
+  simTime = c->simTime;
+  nextEdge = c->nextEdge;
+  sample = c->sample;
+  idle = c->idle;
+  bank->restoreState(c->button);
+  numCkpts = lo + 1;
+  nextCkptTime = simTime + ckptInterval;
+  return (true);
+}
+
+
+/* pushButtonSimClass::saveCheckpoint()
+    Saves the current simulation state to the checkpoint buffer. If the buffer is full, every other checkpoint is dropped
+      and the interval is doubled.
+*/
+void pushButtonSimClass::saveCheckpoint() {
+  uint16_t i;
+
+  if (numCkpts >= ckptSize) {   // buffer full; keep checkpoints 0, 2, 4, ...
+    for (i = 0; (2 * i) < numCkpts; i++)
+      ckpt[i] = ckpt[2 * i];
+    numCkpts = i;
+    ckptInterval *= 2;
+  }
+  ckpt[numCkpts].simTime = simTime;
+  ckpt[numCkpts].nextEdge = nextEdge;
+  ckpt[numCkpts].sample = sample;
+  ckpt[numCkpts].idle = idle;
+  bank->saveState(ckpt[numCkpts].button);
+  numCkpts++;
+  nextCkptTime = simTime + ckptInterval;
+}
+
+
+/* pushButtonSimClass::time()
+    Returns the time of the next update (ms).
+*/
+uint32_t pushButtonSimClass::time() {
+  return (simTime);
+}
+
+
+/* pushButtonSimClass::steps()
+    Returns the number of bank updates performed since init(). The speedup of run() over runFixedTick() is the ratio of 
+      their step counts for the same trace.
+*/
+uint32_t pushButtonSimClass::steps() {
+  return (stepCount);
+}
+
+
+/* pushButtonSimClass::step()
+    Applies the input edges up to simTime, updates every pushbutton at simTime, and collects their events.
+    Returns:
+      bool: true if the state or lockout of any pushbutton changed
+*/
+bool pushButtonSimClass::step(pbEventRecord *events, uint32_t maxEvents, uint32_t &numEvents) {
+  pushButtonClass *btn;
+  stateEnum prevState;
+  bool prevLockout, changed = false;
+  eventEnum ev;
+  uint8_t i;
+
+  applyEdges();
+  for (i = 0; i < bank->getCount(); i++) {
+    btn = bank->getButton(i);
+    prevState = btn->getState();
+    prevLockout = btn->lockedOut();
+    btn->updateSample(sample, simTime);
+    if ((btn->getState() != prevState) || (btn->lockedOut() != prevLockout))
+      changed = true;
+    ev = btn->getEvent();
+    if (ev != NO_PRESS) {
+      if (numEvents < maxEvents) {
+        events[numEvents].time = simTime;
+        events[numEvents].pin = btn->pNum;
+        events[numEvents].event = ev;
+        events[numEvents].count = 1;
+      }
+      numEvents++;
+    }
+  }
+  stepCount++;
+  return (changed);
+}
+
+
+/* pushButtonSimClass::applyEdges()
+    Sets the port value to that of the last edge at or before simTime.
+*/
+void pushButtonSimClass::applyEdges() {
+  while ((nextEdge < traceLen) && (trace[nextEdge].time <= simTime))
+    sample = trace[nextEdge++].sample;
+}
@@ -7,17 +7,14 @@ char msg[80];
 
 
 void setup() {
-  /*  
   Serial.begin(115200);
   delay(3000);
   psb.init(18, LOW, false, (SINGLE_TAP | DOUBLE_TAP | LONG_PRESS));
   //psb.enableEvents(0);
   //psb.setDelays(10, 0, 0);
-  */
 }
 
 void loop() {
-  /*
   psb.update();
   if (psb.eventDetected()) {
     switch (psb.getEvent()) {
@@ -35,5 +32,4 @@ void loop() {
       break;
     }
   }
-  */
 }
@@ -0,0 +1,32 @@
+/* ARDUINO.CPP (host shim)
+    State of the emulated pins and clock (see Arduino.h).
+*/
+
+#include "Arduino.h"
+
+volatile uint32_t hostPort;
+volatile uint32_t hostPort2;
+volatile uint32_t hostPortSet;
+volatile uint32_t hostPortClear;
+uint32_t hostMillis;
+uint32_t hostMicros;
+uint8_t hostPinMode[hostNumPins];
+volatile uint32_t F_BUS_ACTUAL;
+
+
+/* hostReset()
+    Returns the emulated pins and clock to their power-up state.
+*/
+void hostReset() {
+  uint8_t i;
+
+  hostPort = 0;
+  hostPort2 = 0;
+  hostPortSet = 0;
+  hostPortClear = 0;
+  hostMillis = 0;
+  hostMicros = 0;
+  F_BUS_ACTUAL = 150000000;
+  for (i = 0; i < hostNumPins; i++)
+    hostPinMode[i] = INPUT;
+}
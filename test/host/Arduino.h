@@ -0,0 +1,44 @@
+/* ARDUINO.H (host shim)
+    Minimal stand-in for the Arduino/Teensy core, used to build the pushbutton library on a host (tests, benchmarks and the
+      pbhost shared library, see test/CMakeLists.txt). Pins 0-31 are bits 0-31 of the GPIO port hostPort, and pins 32-63
+      are bits 0-31 of a second port, hostPort2. Time only advances when the program sets hostMillis / hostMicros.
+*/
+
+#ifndef _PB_HOST_ARDUINO
+#define _PB_HOST_ARDUINO
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+const uint8_t hostNumPins = 64;
+
+extern volatile uint32_t hostPort;      // input levels of pins 0-31
+extern volatile uint32_t hostPort2;     // input levels of pins 32-63
+extern volatile uint32_t hostPortSet;   // last value written to the port set register
+extern volatile uint32_t hostPortClear; // last value written to the port clear register
+extern uint32_t hostMillis;             // value returned by millis()
+extern uint32_t hostMicros;             // value returned by micros()
+extern uint8_t hostPinMode[hostNumPins];        // last mode set with pinMode()
+extern volatile uint32_t F_BUS_ACTUAL;  // IP bus clock (Hz), 150 MHz after hostReset() (Teensy 4.x at 600 MHz)
+
+inline void pinMode(uint8_t pin, uint8_t mode) { if (pin < hostNumPins) hostPinMode[pin] = mode; }
+inline volatile uint32_t *portInputRegister(uint8_t pin) { return ((pin < 32) ? &hostPort : &hostPort2); }
+inline uint32_t digitalPinToBitMask(uint8_t pin) { return ((uint32_t) 1 << (pin & 31)); }
+inline uint8_t digitalReadFast(uint8_t pin) { return ((*portInputRegister(pin) >> (pin & 31)) & 1); }
+inline volatile uint32_t *portSetRegister(uint8_t pin) { (void) pin; return (&hostPortSet); }
+inline volatile uint32_t *portClearRegister(uint8_t pin) { (void) pin; return (&hostPortClear); }
+inline uint32_t millis() { return (hostMillis); }
+inline uint32_t micros() { return (hostMicros); }
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+void hostReset();
+
+#endif
@@ -0,0 +1,68 @@
+/* BENCH_BLOCK.CPP
+    Throughput of pushButtonClass: one update() per sample (reading the pin and the clock) vs. one updateSample() per
+      captured sample vs. updateBlock() over blocks of captured samples. All three must detect the same events.
+    Usage: bench_block [repeats]
+*/
+
+#include "pbtest.h"
+
+const uint32_t traceLen = 200000;   // ms
+const uint16_t blockLen = 64;
+
+static bool level[traceLen];
+static uint32_t samples[traceLen];
+
+int main(int argc, char **argv) {
+  const int sel = SINGLE_TAP | DOUBLE_TAP | LONG_PRESS;
+  int repeats = (argc > 1) ? atoi(argv[1]) : 20;
+  std::chrono::steady_clock::time_point t0;
+  double tUpdate, tSample, tBlock;
+  uint32_t evUpdate = 0, evSample = 0, evBlock = 0;
+  pushButtonClass b;
+  uint32_t t;
+  int r;
+
+  hostReset();
+  makeTrace(level, traceLen, 1);
+  for (t = 0; t < traceLen; t++)
+    samples[t] = level[t] ? 0 : (1 << 1);   // pin 1, active LOW
+
+  b.init(1, LOW, true, sel);
+  t0 = std::chrono::steady_clock::now();
+  for (r = 0; r < repeats; r++) {
+    for (hostMillis = 0; hostMillis < traceLen; hostMillis++) {
+      hostPort = samples[hostMillis];
+      b.update();
+      evUpdate += (b.getEvent() != NO_PRESS);
+    }
+  }
+  tUpdate = secondsSince(t0);
+
+  b.init(1, LOW, true, sel);
+  t0 = std::chrono::steady_clock::now();
+  for (r = 0; r < repeats; r++) {
+    for (t = 0; t < traceLen; t++) {
+      b.updateSample(samples[t], t);
+      evSample += (b.getEvent() != NO_PRESS);
+    }
+  }
+  tSample = secondsSince(t0);
+
+  b.init(1, LOW, true, sel);
+  t0 = std::chrono::steady_clock::now();
+  for (r = 0; r < repeats; r++) {
+    for (t = 0; t < traceLen; t += blockLen) {
+      b.updateBlock(&samples[t], blockLen, 1, t + blockLen - 1);
+      evBlock += (b.getEvent() != NO_PRESS);
+    }
+  }
+  tBlock = secondsSince(t0);
+
+  printf("update():       %6.2f ns/sample, %u events\n", tUpdate * 1e9 / ((double) repeats * traceLen), evUpdate);
+  printf("updateSample(): %6.2f ns/sample, %u events\n", tSample * 1e9 / ((double) repeats * traceLen), evSample);
+  printf("updateBlock():  %6.2f ns/sample, %u events (last event per block)\n",
+    tBlock * 1e9 / ((double) repeats * traceLen), evBlock);
+  CHECK_EQ(evSample, evUpdate);
+  CHECK(evBlock > 0);
+  return (testResult());
+}
@@ -0,0 +1,71 @@
+/* BENCH_FEEDBACK.CPP
+    Press-to-light latency with feedback outputs driven by the bank in the same scan (pushButtonFeedbackClass, FB_MOCK
+      backend), compared with lighting the LED when the application first sees an event. Random presses are applied to two
+      pushbuttons with different events enabled, showing FB_RAMP while waiting for a long press, and the bank is updated 
+      every millisecond. Every accepted press must light its output in the same scan.
+    Usage: bench_feedback [presses]
+*/
+
+#include "pbtest.h"
+#include "PushbuttonFeedback.h"
+
+int main(int argc, char **argv) {
+  uint32_t presses = (argc > 1) ? (uint32_t) atoi(argv[1]) : 500;
+  pushButtonClass btn[2];
+  pushButtonBankClass bank;
+  pushButtonFeedbackClass fb;
+  uint32_t fbSum[2] = {0, 0}, fbMax[2] = {0, 0}, evSum[2] = {0, 0}, evMax[2] = {0, 0}, count[2] = {0, 0};
+  uint32_t pressAt, releaseAt, lit, seen, lat, p;
+  uint8_t b;
+
+  hostReset();
+  btn[0].init(1, LOW, true, SINGLE_TAP | DOUBLE_TAP | LONG_PRESS);
+  btn[1].init(2, LOW, true, SINGLE_TAP | LONG_PRESS);
+  bank.init(btn, 2);
+  fb.init(FB_MOCK, NULL);
+  fb.setOutput(0, 0);
+  fb.setOutput(1, 1);
+  fb.setPattern(WAIT_LONG, FB_RAMP);
+  bank.attachFeedback(&fb);
+  hostPort = 0x6;   // both released
+  srand(3);
+  hostMillis = 0;
+  for (p = 0; p < presses; p++) {
+    b = p & 1;
+    pressAt = hostMillis + 500 + (rand() % 500);   // idle long enough to return to RDY
+    releaseAt = pressAt + 20 + (rand() % 1500);
+    lit = seen = 0;
+    for (; hostMillis < releaseAt + 1000; hostMillis++) {
+      if (hostMillis == pressAt)
+        hostPort &= ~(1 << (b + 1));
+      if (hostMillis == releaseAt)
+        hostPort |= (1 << (b + 1));
+      bank.update();
+      if ((lit == 0) && (fb.mockBits() & (1 << b)))
+        lit = hostMillis + 1;   // +1 so that 0 means "not yet"
+      if ((seen == 0) && btn[b].eventDetected())
+        seen = hostMillis + 1;
+      btn[b].getEvent();
+    }
+    CHECK(lit != 0);
+    CHECK(seen != 0);
+    if ((lit == 0) || (seen == 0))
+      continue;
+    lat = (lit - 1) - pressAt;
+    CHECK_EQ(lat, 0);
+    fbSum[b] += lat;
+    fbMax[b] = (lat > fbMax[b]) ? lat : fbMax[b];
+    lat = (seen - 1) - pressAt;
+    evSum[b] += lat;
+    evMax[b] = (lat > evMax[b]) ? lat : evMax[b];
+    count[b]++;
+  }
+  for (b = 0; b < 2; b++) {
+    if (count[b] == 0)
+      continue;
+    printf("button %d (%s): %u presses, same-scan feedback mean %.1f / max %u ms, first event mean %.1f / max %u ms\n",
+      b, (b == 0) ? "tap/double/long" : "tap/long", count[b], (double) fbSum[b] / count[b], fbMax[b],
+      (double) evSum[b] / count[b], evMax[b]);
+  }
+  return (testResult());
+}
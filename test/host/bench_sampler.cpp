@@ -0,0 +1,121 @@
+/* BENCH_SAMPLER.CPP
+    CPU load of reading a bank of pushbuttons once per millisecond: each pushbutton polled with update(), the bank polled
+      with a port-wide read (pushButtonBankClass::update()), and the DMA sampler (mocked) with poll() every 20 ms. Counts
+      clock reads, pin/port reads and updates with PB_INSTRUMENT, and measures host time; all three must publish the same
+      events at the same times, in the same order. begin() must reject a 0 ms period and an empty bank.
+    Usage: bench_sampler [traceLen(ms)]
+*/
+
+#include "pbtest.h"
+#include "PushbuttonSampler.h"
+#include "PushbuttonRing.h"
+
+const uint8_t numButtons = 4;
+const uint32_t maxTraceLen = 1000000;
+const uint32_t maxEvents = 20000;
+
+enum methodEnum {POLL_EACH, POLL_BANK, SAMPLER};
+static const char * const methodName[] = {"update() per button", "bank update()", "DMA sampler + poll()"};
+
+static bool level[numButtons][maxTraceLen];
+static pbEventRecord events[3][maxEvents];
+static uint32_t numEvents[3];
+
+static uint32_t portAt(uint32_t t) {
+  uint32_t v = 0;
+  uint8_t b;
+
+  for (b = 0; b < numButtons; b++) {
+    if (!level[b][t])
+      v |= (1 << (b + 1));  // pins 1-4, active LOW
+  }
+  return (v);
+}
+
+static void drain(pushButtonRingClass &ring, int8_t sub, int m) {
+  const pbEventRecord *r;
+
+  while ((r = ring.read(sub)) != NULL) {
+    if (numEvents[m] < maxEvents)
+      events[m][numEvents[m]] = *r;
+    numEvents[m]++;
+  }
+}
+
+int main(int argc, char **argv) {
+  uint32_t traceLen = (argc > 1) ? (uint32_t) atoi(argv[1]) : 200000;
+  pushButtonClass btn[numButtons];
+  pushButtonBankClass bank;
+  pushButtonSamplerClass sampler;
+  pushButtonRingClass ring;
+  std::chrono::steady_clock::time_point t0;
+  double secs;
+  uint32_t i;
+  int8_t sub;
+  uint8_t b;
+  int m;
+
+  if (traceLen > maxTraceLen)
+    traceLen = maxTraceLen;
+  traceLen -= traceLen % samplerHalfSize;
+  hostReset();
+  bank.init(btn, 0);
+  CHECK(!sampler.begin(&bank, 1));  // nothing to sample
+  btn[0].init(1, LOW, true, SINGLE_TAP);
+  bank.init(btn, 1);
+  CHECK(!sampler.begin(&bank, 0));
+  for (b = 0; b < numButtons; b++)
+    makeTrace(level[b], traceLen, b + 1);
+  printf("%u buttons, %u ms, 1 ms sampling\n", numButtons, traceLen);
+  for (m = POLL_EACH; m <= SAMPLER; m++) {
+    ring.init();
+    sub = ring.subscribe();
+    for (b = 0; b < numButtons; b++) {
+      btn[b].init(b + 1, LOW, true, SINGLE_TAP | DOUBLE_TAP | LONG_PRESS);
+      btn[b].attachRing(&ring);
+    }
+    bank.init(btn, numButtons);
+    if (m == SAMPLER)
+      CHECK(sampler.begin(&bank, 1));
+    numEvents[m] = 0;
+    memset(&pbTotalOps, 0, sizeof(pbTotalOps));
+    t0 = std::chrono::steady_clock::now();
+    for (i = 0; i < traceLen; i++) {
+      hostMillis = i;
+      hostPort = portAt(i);
+      if (m == POLL_EACH) {
+        for (b = 0; b < numButtons; b++)
+          btn[b].update();
+      }
+      else if (m == POLL_BANK)
+        bank.update();
+      else {
+        sampler.mockTrigger(hostPort, i);   // done by the PIT and DMA on the target
+        if ((i % 20) == 19)
+          sampler.poll();
+      }
+      drain(ring, sub, m);
+    }
+    if (m == SAMPLER) {
+      sampler.poll();
+      drain(ring, sub, m);
+      CHECK_EQ(sampler.overruns(), 0);
+      sampler.end();
+    }
+    secs = secondsSince(t0);
+    printf("%-22s clockReads %8u  pinReads %8u  updates %8u  %6.2f ns/ms  %u events\n", methodName[m],
+      pbTotalOps.clockReads, pbTotalOps.pinReads, pbTotalOps.updates, secs * 1e9 / traceLen, numEvents[m]);
+  }
+  for (m = POLL_BANK; m <= SAMPLER; m++) {
+    CHECK_EQ(numEvents[m], numEvents[POLL_EACH]);
+    for (i = 0; (i < numEvents[m]) && (i < numEvents[POLL_EACH]) && (i < maxEvents); i++) {
+      if ((events[m][i].time != events[POLL_EACH][i].time) || (events[m][i].pin != events[POLL_EACH][i].pin) ||
+          (events[m][i].event != events[POLL_EACH][i].event)) {
+        printf("%s: event %u differs\n", methodName[m], i);
+        pbTestFailures++;
+        break;
+      }
+    }
+  }
+  return (testResult());
+}
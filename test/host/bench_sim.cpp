@@ -0,0 +1,109 @@
+/* BENCH_SIM.CPP
+    Speedup of the discrete-event simulator (pushButtonSimClass::run()) over a fixed-tick replay (runFixedTick()) of a
+      long, sparse trace: bursts of presses with contact bounce and tap-then-hold gestures, separated by idle periods of
+      up to 10 minutes. Both must detect the same events at the same times, with and without DOUBLE_TAP_HOLD enabled on
+      the first pushbutton.
+    Usage: bench_sim [hours]
+*/
+
+#include "pbtest.h"
+#include <vector>
+#include "PushbuttonSim.h"
+
+const uint32_t maxEvents = 200000;
+const uint32_t idlePort = 0x6;    // pins 1 and 2, active LOW
+
+static pbEventRecord events[2][maxEvents];
+
+  // Random sparse trace over [0, endTime)
+static void makeSparseTrace(std::vector<pbTraceEdge> &trace, uint32_t endTime, unsigned seed) {
+  uint32_t t = 0, port = idlePort, pin, n = 0;
+  int k;
+
+  srand(seed);
+  while (true) {
+    t += ((rand() % 3) == 0) ? (rand() % 600000) : ((rand() % 1500) + 1);
+    if (t >= endTime)
+      break;
+    pin = 1 + (rand() % 2);
+    port ^= (1 << pin);
+    trace.push_back({t, port});
+    if (((++n % 4) == 0) && (port & (1 << 1))) {  // pin 1 released: tap, then press and hold (double-tap-and-hold)
+      t += 1000;
+      trace.push_back({t, port & ~(1 << 1)});
+      trace.push_back({t + 100, port});
+      trace.push_back({t + 200, port & ~(1 << 1)});
+      t += 1700;
+      trace.push_back({t, port});
+    }
+    if ((rand() % 4) == 0) {  // contact bounce
+      for (k = 0; k < 4; k++) {
+        t += 1 + (rand() % 3);
+        trace.push_back({t, port ^ (1 << pin)});
+        t++;
+        trace.push_back({t, port});
+      }
+    }
+  }
+}
+
+  // Replays the trace through a fresh bank; returns the number of events
+static uint32_t replay(const std::vector<pbTraceEdge> &trace, uint32_t endTime, int eventSel, bool fixedTick,
+    pbEventRecord *ev, uint32_t &steps, double &secs) {
+  pushButtonClass btn[2];
+  pushButtonBankClass bank;
+  pushButtonSimClass sim;
+  std::chrono::steady_clock::time_point t0;
+  uint32_t n;
+
+  btn[0].init(1, LOW, true, eventSel);
+  btn[1].init(2, LOW, true, SINGLE_TAP | LONG_PRESS);
+  btn[1].setDelays(20, 0, 500);
+  bank.init(btn, 2);
+  sim.init(&bank, trace.data(), trace.size(), idlePort);
+  t0 = std::chrono::steady_clock::now();
+  n = fixedTick ? sim.runFixedTick(endTime, ev, maxEvents) : sim.run(endTime, ev, maxEvents);
+  secs = secondsSince(t0);
+  steps = sim.steps();
+  return (n);
+}
+
+  // Compares run() with runFixedTick(), with eventSel on the first pushbutton
+static void compare(const std::vector<pbTraceEdge> &trace, uint32_t hours, int eventSel) {
+  uint32_t endTime = hours * 3600000;
+  uint32_t n[2], steps[2], i, holds = 0;
+  double secs[2];
+
+  n[0] = replay(trace, endTime + 5000, eventSel, false, events[0], steps[0], secs[0]);
+  n[1] = replay(trace, endTime + 5000, eventSel, true, events[1], steps[1], secs[1]);
+  for (i = 0; (i < n[0]) && (i < maxEvents); i++)
+    holds += (events[0][i].event == DOUBLE_TAP_HOLD) ? 1 : 0;
+  printf("%u h trace, %u edges, %u events (%u double-tap-and-hold)\n", hours, (uint32_t) trace.size(), n[0], holds);
+  if (eventSel & DOUBLE_TAP_HOLD)
+    CHECK(holds > 0);
+  printf("run():          %10u steps  %8.3f ms\n", steps[0], secs[0] * 1e3);
+  printf("runFixedTick(): %10u steps  %8.3f ms\n", steps[1], secs[1] * 1e3);
+  printf("speedup: %.0fx in steps, %.0fx in time\n", (double) steps[1] / steps[0], secs[1] / secs[0]);
+  CHECK(n[0] > 0);
+  CHECK_EQ(n[0], n[1]);
+  for (i = 0; (i < n[0]) && (i < n[1]) && (i < maxEvents); i++) {
+    if ((events[0][i].time != events[1][i].time) || (events[0][i].pin != events[1][i].pin) ||
+        (events[0][i].event != events[1][i].event)) {
+      printf("event %u differs: %d at %u vs %d at %u\n", i, events[0][i].event, events[0][i].time, events[1][i].event,
+        events[1][i].time);
+      pbTestFailures++;
+      break;
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  uint32_t hours = (argc > 1) ? (uint32_t) atoi(argv[1]) : 2;
+  std::vector<pbTraceEdge> trace;
+
+  hostReset();
+  makeSparseTrace(trace, hours * 3600000, 1);
+  compare(trace, hours, SINGLE_TAP | DOUBLE_TAP | LONG_PRESS);
+  compare(trace, hours, SINGLE_TAP | DOUBLE_TAP | LONG_PRESS | DOUBLE_TAP_HOLD);
+  return (testResult());
+}
@@ -0,0 +1,104 @@
+"""PBHOST.PY
+    ctypes wrapper for the pushbutton host library (libpbhost, built by test/CMakeLists.txt with PB_HOST_API): runs
+      recorded switch captures through the pushbutton engine at native speed and returns the detected events as a
+      structured array (a NumPy array with EVENT_DTYPE when NumPy is installed, otherwise a ctypes array of EventRecord).
+
+    Example:
+      host = PbHost("build-host/libpbhost.so")
+      ev = host.run(samples, times, pins=[3, 4], event_sel=SINGLE_TAP | LONG_PRESS)
+      taps = ev[ev["event"] == SINGLE_TAP]["time"]
+"""
+
+import ctypes
+
+try:
+    import numpy as np
+except ImportError:
+    np = None
+
+# eventEnum and logic levels (Pushbutton.h, Arduino.h)
+NO_PRESS, SINGLE_TAP, DOUBLE_TAP, LONG_PRESS, DOUBLE_TAP_HOLD = 0, 1, 2, 4, 8
+LOW, HIGH = 0, 1
+MAX_BUTTONS = 8   # hostMaxButtons (PushbuttonHost.h)
+INITIAL_EVENTS = 256  # size of the first output buffer when max_events is not given
+
+
+class EventRecord(ctypes.Structure):
+    """pbEventRecord (PushbuttonRing.h)"""
+    _fields_ = [("time", ctypes.c_uint32), ("pin", ctypes.c_uint8), ("event", ctypes.c_int32),
+                ("count", ctypes.c_uint8)]
+
+
+if np is not None:
+    EVENT_DTYPE = np.dtype({"names": ["time", "pin", "event", "count"], "formats": ["<u4", "u1", "<i4", "u1"],
+                            "offsets": [0, 4, 8, 12], "itemsize": 16})
+
+
+def _u32_array(values):
+    """Returns (pointer, keep-alive object) for a uint32 array, without copying contiguous NumPy uint32 arrays."""
+    if (np is not None) and isinstance(values, np.ndarray):
+        a = np.ascontiguousarray(values, dtype=np.uint32)
+        return a.ctypes.data_as(ctypes.POINTER(ctypes.c_uint32)), a
+    a = (ctypes.c_uint32 * len(values))(*values)
+    return a, a
+
+
+class PbHost:
+    """Loaded pushbutton host library."""
+
+    def __init__(self, path):
+        self.lib = ctypes.CDLL(path)
+        self.lib.pbHostRun.restype = ctypes.c_uint32
+        self.lib.pbHostRun.argtypes = [ctypes.POINTER(ctypes.c_uint32), ctypes.POINTER(ctypes.c_uint32),
+                                       ctypes.c_uint32, ctypes.POINTER(ctypes.c_uint8), ctypes.c_uint8, ctypes.c_uint8,
+                                       ctypes.c_int, ctypes.c_uint16, ctypes.c_uint16, ctypes.c_uint16,
+                                       ctypes.POINTER(EventRecord), ctypes.c_uint32]
+        self.lib.pbHostEventSize.restype = ctypes.c_uint32
+        if self.lib.pbHostEventSize() != ctypes.sizeof(EventRecord):
+            raise RuntimeError("pbEventRecord size mismatch: library %d, EventRecord %d bytes" %
+                               (self.lib.pbHostEventSize(), ctypes.sizeof(EventRecord)))
+
+    def run(self, samples, times, pins, act_level=LOW, event_sel=SINGLE_TAP, db_period=0, double_dly=0, long_dur=0,
+            max_events=None):
+        """Runs a capture through a fresh set of pushbuttons (see pbHostRun() in PushbuttonHost.cpp).
+            samples: port samples; bit n is the level of the pushbutton with pin n
+            times: time of each sample (ms), non-decreasing
+            pins: bit position in samples (0-31) of each pushbutton
+            max_events: maximum number of events returned; by default all events are returned (the events are written
+              into a buffer of INITIAL_EVENTS records, and the capture is run again with a larger buffer only if more
+              events were detected)
+          Returns the detected events, in order (at most max_events). With NumPy, the events are written by the library
+            straight into the returned array.
+        """
+        if len(samples) != len(times):
+            raise ValueError("samples and times differ in length")
+        if (len(pins) > MAX_BUTTONS) or any((p < 0) or (p >= 32) for p in pins):
+            raise ValueError("at most %d pins, with bit positions 0-31" % MAX_BUTTONS)
+        sp, s_keep = _u32_array(samples)
+        tp, t_keep = _u32_array(times)
+        pin_arr = (ctypes.c_uint8 * len(pins))(*pins)
+        args = (sp, tp, len(samples), pin_arr, len(pins), act_level, event_sel, db_period, double_dly, long_dur)
+        size = INITIAL_EVENTS if max_events is None else max_events
+        events, ep = self._alloc(size)
+        n = self.lib.pbHostRun(*args, ep, size)
+        if (max_events is None) and (n > size):   # buffer too small: run again with room for every event
+            size = n
+            events, ep = self._alloc(size)
+            n = self.lib.pbHostRun(*args, ep, size)
+        n = min(n, size)
+        if np is not None:
+            return events[:n]
+        if n < size:
+            trimmed = (EventRecord * n)()
+            ctypes.memmove(trimmed, events, n * ctypes.sizeof(EventRecord))
+            events = trimmed
+        return events
+
+    @staticmethod
+    def _alloc(size):
+        """Returns (array, pointer) for an output buffer of size events."""
+        if np is not None:
+            a = np.empty(size, dtype=EVENT_DTYPE)
+            return a, a.ctypes.data_as(ctypes.POINTER(EventRecord))
+        a = (EventRecord * size)()
+        return a, a
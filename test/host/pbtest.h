@@ -0,0 +1,161 @@
+/* PBTEST.H
+    Helpers shared by the host tests and benchmarks: check macros, a random bouncy switch trace, and a reference model of
+      the original pushButtonClass (elapsedMillis timers, one update() per call) for equivalence tests.
+*/
+
+#ifndef _PB_TEST
+#define _PB_TEST
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include "Pushbutton.h"
+
+static int pbTestFailures = 0;
+
+#define CHECK(cond) do { if (!(cond)) { printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+  pbTestFailures++; } } while (0)
+#define CHECK_EQ(a, b) do { long long va_ = (long long) (a), vb_ = (long long) (b); if (va_ != vb_) { \
+  printf("%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", __FILE__, __LINE__, #a, #b, va_, vb_); \
+  pbTestFailures++; } } while (0)
+
+static inline int testResult() {
+  if (pbTestFailures == 0)
+    printf("PASS\n");
+  return ((pbTestFailures == 0) ? 0 : 1);
+}
+
+  /* Seconds elapsed since a steady_clock time point, for benchmarks */
+static inline double secondsSince(std::chrono::steady_clock::time_point t0) {
+  return (std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count());
+}
+
+
+  /* Random switch trace: level[t] is true while the switch is pressed at time t (ms). Presses and releases last 0-1500 ms,
+      with short (0-20 ms) bursts of contact bounce mixed in.
+  */
+static inline void makeTrace(bool *level, uint32_t len, unsigned seed) {
+  uint32_t t = 0, d, k;
+  bool l = false;
+
+  srand(seed);
+  while (t < len) {
+    d = ((rand() % 5) == 0) ? (rand() % 20) : (rand() % 1500);
+    for (k = 0; (k < d) && (t < len); k++)
+      level[t++] = l;
+    l = !l;
+  }
+}
+
+
+  /* Event detected at a given time */
+struct testEvent {
+  uint32_t time;
+  eventEnum event;
+};
+
+
+  /* Reference model: the state machine of the original pushButtonClass, with its elapsedMillis timers emulated from
+      hostMillis. Only SINGLE_TAP, DOUBLE_TAP and LONG_PRESS are supported.
+  */
+class refElapsed {
+  uint32_t start = 0;
+public:
+  operator uint32_t() const { return (hostMillis - start); }
+  refElapsed &operator=(uint32_t v) { start = hostMillis - v; return (*this); }
+};
+
+class refButtonClass {
+  uint8_t pNum, activeLevel;
+  stateEnum state;
+  refElapsed delayTimer, lockoutTimer;
+  uint16_t debouncePeriod = defDebouncePeriod, doubleTapDelay = defDoubleTapDelay, longPressDuration = defLongPressDur;
+  bool buttonActive, lockout, doubleTapEnabled, longPressEnabled;
+public:
+  eventEnum event;
+
+  void init(uint8_t ioPinNum, uint8_t actLevel, int eventSel) {
+    pNum = ioPinNum;
+    activeLevel = actLevel;
+    state = RDY;
+    event = NO_PRESS;
+    lockout = false;
+    doubleTapEnabled = (eventSel & DOUBLE_TAP);
+    longPressEnabled = (eventSel & LONG_PRESS);
+  }
+
+  void setDelays(uint16_t dbPeriod, uint16_t doubleDly, uint16_t longDur) {
+    if (dbPeriod > 0)
+      debouncePeriod = dbPeriod;
+    if (doubleDly > 0)
+      doubleTapDelay = doubleDly;
+    if (longDur > 0)
+      longPressDuration = longDur;
+  }
+
+  void update() {
+    if (lockout) {
+      if (lockoutTimer > debouncePeriod)
+        lockout = false;
+      return;
+    }
+    buttonActive = (((hostPort >> pNum) & 1) == activeLevel);
+    switch (state) {
+      case RDY:
+        if (buttonActive) {
+          lockout = true;
+          lockoutTimer = 0;
+          delayTimer = 0;
+          if (doubleTapEnabled || longPressEnabled)
+            state = WAIT_LONG;
+          else {
+            event = SINGLE_TAP;
+            state = WAIT_INACTIVE;
+          }
+        }
+      break;
+      case WAIT_LONG:
+        if (buttonActive) {
+          if (longPressEnabled && (delayTimer > longPressDuration)) {
+            event = LONG_PRESS;
+            state = WAIT_INACTIVE;
+          }
+        }
+        else {
+          lockout = true;
+          lockoutTimer = 0;
+          if (doubleTapEnabled)
+            state = WAIT_DOUBLE;
+          else {
+            event = SINGLE_TAP;
+            state = RDY;
+          }
+        }
+      break;
+      case WAIT_DOUBLE:
+        if (delayTimer > doubleTapDelay) {
+          event = SINGLE_TAP;
+          state = RDY;
+        }
+        else if (buttonActive) {
+          lockout = true;
+          lockoutTimer = 0;
+          event = DOUBLE_TAP;
+          state = WAIT_INACTIVE;
+        }
+      break;
+      case WAIT_INACTIVE:
+        if (!buttonActive) {
+          lockout = true;
+          lockoutTimer = 0;
+          state = RDY;
+        }
+      break;
+      default:
+      break;
+    }
+  }
+};
+
+#endif
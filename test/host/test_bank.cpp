@@ -0,0 +1,99 @@
+/* TEST_BANK.CPP
+    Checks pushButtonBankClass port detection, that updateBlock() ignores port samples when the pushbuttons are on
+      different ports (each pushbutton would otherwise test its bit in another port's sample), and that updateBlock()
+      publishes the events of all pushbuttons to a shared ring in time order.
+*/
+
+#include "pbtest.h"
+#include "PushbuttonBank.h"
+#include "PushbuttonRing.h"
+
+const uint8_t pinA = 3;     // on hostPort
+const uint8_t pinB = 35;    // on hostPort2, same bit number as pinA
+
+  // Presses and releases pinA at start (sample value: active LOW), leaving pinB released
+static void fillTap(uint32_t *samples, uint16_t count) {
+  uint16_t i;
+
+  for (i = 0; i < count; i++)
+    samples[i] = ((i >= 10) && (i < 200)) ? 0 : (1 << (pinA & 31));
+}
+
+  // Pin 2 and pin 1 long presses detected within one 64-sample block (1024-1087 ms): pin 2's event must come first
+static void testRingOrder() {
+  pushButtonClass btn[2];
+  pushButtonBankClass bank;
+  pushButtonRingClass ring;
+  const pbEventRecord *r;
+  uint32_t samples[64], lastTime = 0;
+  uint16_t i, block;
+  int8_t sub;
+
+  hostReset();
+  ring.init();
+  sub = ring.subscribe();
+  btn[0].init(1, LOW, true, SINGLE_TAP | LONG_PRESS);
+  btn[1].init(2, LOW, true, SINGLE_TAP | LONG_PRESS);
+  btn[0].attachRing(&ring);
+  btn[1].attachRing(&ring);
+  bank.init(btn, 2);
+  for (block = 0; block < 40; block++) {  // presses at 29 and 79 ms
+    for (i = 0; i < 64; i++) {
+      uint32_t t = block * 64 + i;
+      samples[i] = (((t >= 29) && (t < 1500)) ? 0 : (1 << 2)) | (((t >= 79) && (t < 1500)) ? 0 : (1 << 1));
+    }
+    lastTime = block * 64 + 63;
+    bank.updateBlock(samples, 64, 1, lastTime);
+  }
+  r = ring.read(sub);
+  CHECK((r != NULL) && (r->pin == 2) && (r->event == LONG_PRESS) && (r->time == 1030));
+  r = ring.read(sub);
+  CHECK((r != NULL) && (r->pin == 1) && (r->event == LONG_PRESS) && (r->time == 1080));
+  CHECK(ring.read(sub) == NULL);
+}
+
+int main() {
+  pushButtonClass btn[2];
+  pushButtonBankClass bank;
+  uint32_t samples[1000];
+  pbButtonState st;
+
+  hostReset();
+  fillTap(samples, 1000);
+
+    // Same port: the block is processed
+  btn[0].init(pinA, LOW, true, SINGLE_TAP);
+  btn[1].init(pinA + 1, LOW, true, SINGLE_TAP);
+  bank.init(btn, 2);
+  CHECK(bank.getPort() == &hostPort);
+  CHECK_EQ(bank.getPortMask(), (1u << pinA) | (1u << (pinA + 1)));
+  bank.updateBlock(samples, 1000, 1, 999);
+  CHECK_EQ(btn[0].getEvent(), SINGLE_TAP);
+  CHECK_EQ(btn[1].getEvent(), SINGLE_TAP);   // pin pinA + 1 reads LOW (pressed) throughout
+
+    // Different ports: the block is ignored and no pushbutton state changes
+  btn[0].init(pinA, LOW, true, SINGLE_TAP);
+  btn[1].init(pinB, LOW, true, SINGLE_TAP);
+  bank.init(btn, 2);
+  CHECK(bank.getPort() == NULL);
+  CHECK_EQ(bank.getPortMask(), 0);
+  bank.updateBlock(samples, 1000, 1, 999);
+  CHECK_EQ(btn[0].getEvent(), NO_PRESS);
+  CHECK_EQ(btn[1].getEvent(), NO_PRESS);
+  btn[1].saveState(st);
+  CHECK_EQ(st.state, RDY);
+  CHECK(!st.lockout);
+
+    // Different ports: update() reads each pin
+  hostPort = (1 << pinA);   // pinA released
+  hostPort2 = 0;            // pinB pressed
+  for (hostMillis = 0; hostMillis < 200; hostMillis++)
+    bank.update();
+  hostPort2 = (1 << (pinB & 31));  // pinB released
+  for (; hostMillis < 400; hostMillis++)
+    bank.update();
+  CHECK_EQ(btn[0].getEvent(), NO_PRESS);
+  CHECK_EQ(btn[1].getEvent(), SINGLE_TAP);
+  testRingOrder();
+  return (testResult());
+}
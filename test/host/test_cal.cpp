@@ -0,0 +1,80 @@
+/* TEST_CAL.CPP
+    Checks pushButtonCalClass (with emulated EEPROM): round trip, save after init() without load(), wear levelling over
+      the slots, recovery from a corrupted newest record, and reads past the end of the EEPROM.
+*/
+
+#include "pbtest.h"
+#include "PushbuttonCal.h"
+
+extern uint8_t calEmuEeprom[];
+
+static uint16_t debounceOf(pushButtonClass &b) {
+  uint16_t db, dbl, lng;
+
+  b.getDelays(db, dbl, lng);
+  return (db);
+}
+
+static void saveDebounce(pushButtonCalClass &cal, uint16_t db) {
+  pushButtonClass b[2];
+
+  b[0].init(1, LOW, true, SINGLE_TAP);
+  b[1].init(2, LOW, true, SINGLE_TAP);
+  b[1].setDelays(db, 0, 0);
+  cal.save(b, 2);
+}
+
+static bool loadDebounce(uint16_t addr, uint16_t &db) {
+  pushButtonCalClass cal;
+  pushButtonClass b[2];
+  bool ok;
+
+  b[0].init(1, LOW, true, SINGLE_TAP);
+  b[1].init(2, LOW, true, SINGLE_TAP);
+  cal.init(addr);
+  ok = cal.load(b, 2);
+  db = debounceOf(b[1]);
+  return (ok);
+}
+
+int main() {
+  pushButtonCalClass cal;
+  uint16_t db;
+  int i;
+
+  hostReset();
+  memset(calEmuEeprom, 0xFF, calEmuSize);
+
+    // Empty store
+  CHECK(!loadDebounce(16, db));
+  CHECK_EQ(db, defDebouncePeriod);
+
+    // Round trip, and each save goes to the next slot
+  cal.init(16);
+  for (i = 0; i < 4; i++)
+    saveDebounce(cal, 10 + i);
+  CHECK(loadDebounce(16, db));
+  CHECK_EQ(db, 13);
+
+    // Saving after a fresh init() (no load()) continues after the newest record rather than overwriting slot 0
+  cal.init(16);
+  saveDebounce(cal, 99);
+  CHECK(loadDebounce(16, db));
+  CHECK_EQ(db, 99);
+
+    // Wraps around all slots
+  for (i = 0; i < 3 * calNumSlots; i++)
+    saveDebounce(cal, 20 + i);
+  CHECK(loadDebounce(16, db));
+  CHECK_EQ(db, 20 + (3 * calNumSlots) - 1);
+
+    // A corrupted newest record falls back to the previous one
+  calEmuEeprom[16 + (((4 + (3 * calNumSlots)) % calNumSlots) * sizeof(pbCalRecord)) + 6] ^= 1;
+  CHECK(loadDebounce(16, db));
+  CHECK_EQ(db, 20 + (3 * calNumSlots) - 2);
+
+    // Store extending past the end of the EEPROM: nothing is found, even with stale data in the buffer
+  CHECK(!loadDebounce(calEmuSize - sizeof(pbCalRecord), db));
+  CHECK_EQ(db, defDebouncePeriod);
+  return (testResult());
+}
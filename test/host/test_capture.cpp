@@ -0,0 +1,160 @@
+/* TEST_CAPTURE.CPP
+    Checks edge-capture input (PB_EDGE_CAPTURE, with the mocked capture hardware): captured QuadTimer counts must
+      convert to micros() time, and events detected by updateEdges() must match update() called every millisecond
+      (refButtonClass) in type and time, however often updateEdges() is called, including deadlines that expire between
+      queued edges.
+*/
+
+#include "pbtest.h"
+#include "PushbuttonCapture.h"
+#include "PushbuttonRing.h"
+
+const uint32_t traceLen = 120000;   // ms
+const uint8_t testPin = 1;          // active LOW
+
+static bool level[traceLen];
+static testEvent refEvents[traceLen / 10];
+
+  // Replaces bounce shorter than minLen ms by the previous level, so that at most one edge occurs every minLen ms
+static void limitEdgeRate(bool *lv, uint32_t len, uint32_t minLen) {
+  uint32_t t, start = 0, k;
+
+  for (t = 1; t < len; t++) {
+    if (lv[t] == lv[t - 1])
+      continue;
+    if ((t - start) < minLen) {   // previous segment too short
+      for (k = start; k < t; k++)
+        lv[k] = (start > 0) ? lv[start - 1] : false;
+    }
+    start = t;
+  }
+}
+
+static uint32_t runReference(int eventSel) {
+  refButtonClass ref;
+  uint32_t n = 0;
+
+  ref.init(testPin, LOW, eventSel);
+  for (hostMillis = 0; hostMillis < traceLen; hostMillis++) {
+    hostPort = level[hostMillis] ? 0 : (1 << testPin);
+    ref.update();
+    if (ref.event != NO_PRESS) {
+      refEvents[n].time = hostMillis;
+      refEvents[n++].event = ref.event;
+      ref.event = NO_PRESS;
+    }
+  }
+  return (n);
+}
+
+  // Feeds the trace's edges through capture slot "slot", calling updateEdges() at random intervals of 1 to maxInterval ms
+static void runCapture(int eventSel, uint32_t maxInterval, uint32_t numRef) {
+  pushButtonClass btn;
+  pushButtonRingClass ring;
+  const pbEventRecord *r;
+  uint32_t n = 0, nextUpdate = 0;
+  int8_t sub, slot;
+
+  hostReset();
+  hostPort = (1 << testPin);
+  ring.init();
+  sub = ring.subscribe();
+  btn.init(testPin, LOW, true, eventSel);
+  btn.attachRing(&ring);
+  slot = pushButtonCaptureClass::attach(&btn);
+  CHECK(slot >= 0);
+  for (hostMillis = 0; hostMillis < traceLen; hostMillis++) {
+    hostMicros = hostMillis * 1000;
+    if ((hostMillis > 0) && (level[hostMillis] != level[hostMillis - 1]))
+      pushButtonCaptureClass::mockEdge(slot, level[hostMillis] ? LOW : HIGH, hostMicros);
+    if ((hostMillis == nextUpdate) || (hostMillis == (traceLen - 1))) {
+      btn.updateEdges();
+      nextUpdate += 1 + (rand() % maxInterval);
+      while ((r = ring.read(sub)) != NULL) {
+        if ((n < numRef) && ((r->time != refEvents[n].time) || (r->event != refEvents[n].event))) {
+          printf("interval %u: event %d at %u, expected %d at %u\n", maxInterval, r->event, r->time,
+            refEvents[n].event, refEvents[n].time);
+          pbTestFailures++;
+        }
+        n++;
+      }
+    }
+  }
+  CHECK_EQ(n, numRef);
+  pushButtonCaptureClass::detach(&btn);
+}
+
+  // Press at 100 ms, release at 1500 ms, first updateEdges() call at 2000 ms: the long press must be detected at 1001 ms
+static void testLongPressBetweenEdges() {
+  pushButtonClass btn;
+  pushButtonRingClass ring;
+  const pbEventRecord *r;
+  int8_t sub;
+
+  hostReset();
+  hostPort = (1 << testPin);
+  ring.init();
+  sub = ring.subscribe();
+  btn.init(testPin, LOW, true, SINGLE_TAP | DOUBLE_TAP | LONG_PRESS);
+  btn.attachRing(&ring);
+  btn.captureEdge(LOW, 100000);
+  btn.captureEdge(HIGH, 1500000);
+  hostMillis = 2000;
+  hostMicros = 2000000;
+  btn.updateEdges();
+  r = ring.read(sub);
+  CHECK((r != NULL) && (r->event == LONG_PRESS) && (r->time == 1101));
+  CHECK(ring.read(sub) == NULL);
+  CHECK_EQ(btn.pressMicros(), 100000);
+}
+
+  // Captured QuadTimer counts must convert to micros() time, also across a counter wrap, with the tick length taken
+  // from the bus clock at attach()
+static void testEdgeMicros() {
+  pushButtonClass btn;
+  int8_t slot;
+
+  hostReset();  // 150 MHz bus clock (600 MHz CPU)
+  btn.init(1, LOW, true, SINGLE_TAP);
+  slot = pushButtonCaptureClass::attach(&btn);
+  CHECK(slot >= 0);
+  CHECK_EQ(pushButtonCaptureClass::edgeMicros(1000, 1000, 5000000), 5000000);
+  CHECK_EQ(pushButtonCaptureClass::edgeMicros(1000, 1150, 5000000), 5000000 - 128);
+  CHECK_EQ(pushButtonCaptureClass::edgeMicros(65500, 114, 5000000), 5000000 - 128);   // wrapped
+  CHECK_EQ(pushButtonCaptureClass::edgeMicros(1, 0, 5000000), 5000000 - 55923);      // one period minus a tick
+  CHECK_EQ(pushButtonCaptureClass::edgeMicros(100, 200, 50), (uint32_t) (50 - 85));   // micros() wrap
+  pushButtonCaptureClass::detach(&btn);
+
+  F_BUS_ACTUAL = 99000000;  // 396 MHz CPU: 1.293 us tick
+  CHECK_EQ(pushButtonCaptureClass::attach(&btn), slot);
+  CHECK_EQ(pushButtonCaptureClass::edgeMicros(1000, 1150, 5000000), 5000000 - 194);
+  CHECK_EQ(pushButtonCaptureClass::edgeMicros(1, 0, 5000000), 5000000 - 84732);
+  pushButtonCaptureClass::setBusClock(150000000);   // e.g. after set_arm_clock(600000000)
+  CHECK_EQ(pushButtonCaptureClass::edgeMicros(1000, 1150, 5000000), 5000000 - 128);
+  pushButtonCaptureClass::detach(&btn);
+}
+
+int main() {
+  const int eventSels[] = {SINGLE_TAP, SINGLE_TAP | DOUBLE_TAP, SINGLE_TAP | LONG_PRESS,
+    SINGLE_TAP | DOUBLE_TAP | LONG_PRESS};
+  uint32_t numRef;
+  unsigned seed;
+  uint8_t e;
+
+  testEdgeMicros();
+  testLongPressBetweenEdges();
+  for (seed = 1; seed <= 4; seed++) {
+    makeTrace(level, traceLen, seed);
+    for (e = 0; e < 4; e++) {
+      numRef = runReference(eventSels[e]);
+      CHECK(numRef > 0);
+      runCapture(eventSels[e], edgeFifoSize, numRef);   // bouncy input, at most edgeFifoSize edges between calls
+    }
+    limitEdgeRate(level, traceLen, 50);
+    for (e = 0; e < 4; e++) {
+      numRef = runReference(eventSels[e]);
+      runCapture(eventSels[e], 50 * edgeFifoSize, numRef);   // clean input, calls up to 400 ms apart
+    }
+  }
+  return (testResult());
+}
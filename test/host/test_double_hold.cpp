@@ -0,0 +1,74 @@
+/* TEST_DOUBLE_HOLD.CPP
+    Checks the double-tap-and-hold gesture (PB_DOUBLE_TAP_HOLD) with update() every millisecond: a held second press
+      reports DOUBLE_TAP_HOLD at second press + longPressDuration + 1, a short second press reports DOUBLE_TAP when it is
+      released (not when it is pressed, as without DOUBLE_TAP_HOLD), and nextDeadline() and holdProgress() follow the
+      hold in WAIT_DOUBLE_HOLD.
+*/
+
+#include "pbtest.h"
+#include "Pushbutton.h"
+
+const uint8_t testPin = 1;  // active LOW
+const int allEvents = SINGLE_TAP | DOUBLE_TAP | LONG_PRESS | DOUBLE_TAP_HOLD;
+
+  // Runs tap (100-200 ms) and second press (300 ms to release) until endTime; returns the first event and its time
+static eventEnum runGesture(pushButtonClass &btn, int eventSel, uint32_t release, uint32_t endTime, uint32_t &evTime) {
+  eventEnum ev;
+
+  hostReset();
+  hostPort = (1 << testPin);
+  btn.init(testPin, LOW, true, eventSel);
+  for (hostMillis = 0; hostMillis < endTime; hostMillis++) {
+    if ((hostMillis == 100) || (hostMillis == 300))
+      hostPort &= ~(1 << testPin);
+    if ((hostMillis == 200) || (hostMillis == release))
+      hostPort |= (1 << testPin);
+    btn.update();
+    ev = btn.getEvent();
+    if (ev != NO_PRESS) {
+      evTime = hostMillis;
+      return (ev);
+    }
+  }
+  return (NO_PRESS);
+}
+
+int main() {
+  pushButtonClass btn;
+  uint32_t t = 0, deadline = 0;
+
+    // Held second press
+  CHECK_EQ(runGesture(btn, allEvents, 3000, 3000, t), DOUBLE_TAP_HOLD);
+  CHECK_EQ(t, 300 + defLongPressDur + 1);
+
+    // Short second press: DOUBLE_TAP at the release (after the lockout of the second press)
+  CHECK_EQ(runGesture(btn, allEvents, 450, 3000, t), DOUBLE_TAP);
+  CHECK_EQ(t, 450);
+
+    // Without DOUBLE_TAP_HOLD, DOUBLE_TAP is reported at the second press
+  CHECK_EQ(runGesture(btn, SINGLE_TAP | DOUBLE_TAP | LONG_PRESS, 450, 3000, t), DOUBLE_TAP);
+  CHECK_EQ(t, 300);
+
+    // A held first press is still a long press
+  hostReset();
+  hostPort = (1 << testPin);
+  btn.init(testPin, LOW, true, allEvents);
+  for (hostMillis = 0; hostMillis < 2000; hostMillis++) {
+    if (hostMillis == 100)
+      hostPort &= ~(1 << testPin);
+    btn.update();
+    if (btn.eventDetected())
+      break;
+  }
+  CHECK_EQ(btn.getEvent(), LONG_PRESS);
+  CHECK_EQ(hostMillis, 100 + defLongPressDur + 1);
+
+    // Deadline and progress while waiting for the hold
+  CHECK_EQ(runGesture(btn, allEvents, 3000, 800, t), NO_PRESS);
+  CHECK_EQ(btn.getState(), WAIT_DOUBLE_HOLD);
+  CHECK(btn.nextDeadline(799, deadline));
+  CHECK_EQ(deadline, 300 + defLongPressDur + 1);
+  CHECK_EQ(btn.holdProgress(800), (500 * 255) / defLongPressDur);
+  CHECK_EQ(btn.holdProgress(300 + defLongPressDur), 255);
+  return (testResult());
+}
@@ -0,0 +1,151 @@
+/* TEST_EQUIVALENCE.CPP
+    Checks that the timestamp-based state machine (pushButtonClass::runState()) detects the same events at the same times
+      as the original elapsedMillis implementation (refButtonClass), when replayed once per millisecond through update(),
+      updateSample(), updateBlock() and pushButtonBankClass, for random bouncy traces and several settings. Except when
+      each pushbutton processes its own blocks (MODE_BLOCK), the shared ring must also be in time order across buttons.
+*/
+
+#include "pbtest.h"
+#include "PushbuttonBank.h"
+#include "PushbuttonRing.h"
+
+const uint32_t traceLen = 60032;    // ms (multiple of blockLen)
+const uint16_t blockLen = 64;       // samples per updateBlock() call
+const uint8_t numModes = 5;
+
+enum modeEnum {MODE_UPDATE, MODE_SAMPLE, MODE_BLOCK, MODE_BANK, MODE_BANK_BLOCK};
+
+static bool level[2][traceLen];
+static testEvent refEvents[2][traceLen / 10];
+static uint32_t numRef[2];
+static uint32_t lastEventTime;   // time of the last event read from the ring
+
+  // Port value at time t: button 0 is pin 1 (active LOW), button 1 is pin 6 (active HIGH)
+static uint32_t portAt(uint32_t t) {
+  return ((level[0][t] ? 0 : (1 << 1)) | (level[1][t] ? (1 << 6) : 0));
+}
+
+static void runReference(int eventSel, uint16_t db, uint16_t dbl, uint16_t lng) {
+  refButtonClass ref[2];
+  uint8_t b;
+
+  ref[0].init(1, LOW, eventSel);
+  ref[1].init(6, HIGH, eventSel);
+  numRef[0] = numRef[1] = 0;
+  for (b = 0; b < 2; b++)
+    ref[b].setDelays(db, dbl, lng);
+  for (hostMillis = 0; hostMillis < traceLen; hostMillis++) {
+    hostPort = portAt(hostMillis);
+    for (b = 0; b < 2; b++) {
+      ref[b].update();
+      if (ref[b].event != NO_PRESS) {
+        refEvents[b][numRef[b]].time = hostMillis;
+        refEvents[b][numRef[b]++].event = ref[b].event;
+        ref[b].event = NO_PRESS;
+      }
+    }
+  }
+}
+
+  // Checks the events published to the ring since the last call against the reference
+static void drain(pushButtonRingClass &ring, int8_t sub, pushButtonClass *btn, uint32_t *n, int mode) {
+  const pbEventRecord *r;
+  uint8_t b;
+
+  while ((r = ring.read(sub)) != NULL) {
+    if ((mode != MODE_BLOCK) && (r->time < lastEventTime)) {
+      printf("mode %d: event at %u after event at %u\n", mode, r->time, lastEventTime);
+      pbTestFailures++;
+    }
+    lastEventTime = r->time;
+    b = (r->pin == btn[0].pNum) ? 0 : 1;
+    if (n[b] >= numRef[b]) {
+      printf("mode %d: extra event %d at %u\n", mode, r->event, r->time);
+      pbTestFailures++;
+      continue;
+    }
+    if ((r->time != refEvents[b][n[b]].time) || (r->event != refEvents[b][n[b]].event)) {
+      printf("mode %d button %d: event %d at %u, expected %d at %u\n", mode, b, r->event, r->time,
+        refEvents[b][n[b]].event, refEvents[b][n[b]].time);
+      pbTestFailures++;
+    }
+    n[b]++;
+  }
+}
+
+static void runMode(int mode, int eventSel, uint16_t db, uint16_t dbl, uint16_t lng) {
+  pushButtonClass btn[2];
+  pushButtonBankClass bank;
+  pushButtonRingClass ring;
+  uint32_t samples[blockLen];
+  uint32_t n[2] = {0, 0};
+  uint32_t t, i;
+  int8_t sub;
+  uint8_t b;
+
+  ring.init();
+  sub = ring.subscribe();
+  lastEventTime = 0;
+  btn[0].init(1, LOW, true, eventSel);
+  btn[1].init(6, HIGH, false, eventSel);
+  for (b = 0; b < 2; b++) {
+    btn[b].setDelays(db, dbl, lng);
+    btn[b].attachRing(&ring);
+  }
+  bank.init(btn, 2);
+  if ((mode == MODE_BLOCK) || (mode == MODE_BANK_BLOCK)) {
+    for (t = 0; t < traceLen; t += blockLen) {
+      for (i = 0; i < blockLen; i++)
+        samples[i] = portAt(t + i);
+      if (mode == MODE_BLOCK) {
+        for (b = 0; b < 2; b++)
+          btn[b].updateBlock(samples, blockLen, 1, t + blockLen - 1);
+      }
+      else
+        bank.updateBlock(samples, blockLen, 1, t + blockLen - 1);
+      drain(ring, sub, btn, n, mode);
+    }
+  }
+  else {
+    for (hostMillis = 0; hostMillis < traceLen; hostMillis++) {
+      hostPort = portAt(hostMillis);
+      if (mode == MODE_UPDATE) {
+        for (b = 0; b < 2; b++)
+          btn[b].update();
+      }
+      else if (mode == MODE_SAMPLE) {
+        for (b = 0; b < 2; b++)
+          btn[b].updateSample(hostPort, hostMillis);
+      }
+      else
+        bank.update();
+      drain(ring, sub, btn, n, mode);
+    }
+  }
+  CHECK_EQ(n[0], numRef[0]);
+  CHECK_EQ(n[1], numRef[1]);
+}
+
+int main() {
+  const int eventSels[] = {SINGLE_TAP, SINGLE_TAP | DOUBLE_TAP, SINGLE_TAP | LONG_PRESS,
+    SINGLE_TAP | DOUBLE_TAP | LONG_PRESS};
+  const uint16_t delays[][3] = {{0, 0, 0}, {10, 150, 400}, {25, 500, 2000}};
+  unsigned seed;
+  uint8_t e, d;
+  int mode;
+
+  hostReset();
+  for (seed = 1; seed <= 6; seed++) {
+    makeTrace(level[0], traceLen, seed);
+    makeTrace(level[1], traceLen, seed + 1000);
+    for (e = 0; e < 4; e++) {
+      for (d = 0; d < 3; d++) {
+        runReference(eventSels[e], delays[d][0], delays[d][1], delays[d][2]);
+        CHECK(numRef[0] > 0);
+        for (mode = 0; mode < numModes; mode++)
+          runMode(mode, eventSels[e], delays[d][0], delays[d][1], delays[d][2]);
+      }
+    }
+  }
+  return (testResult());
+}
@@ -0,0 +1,76 @@
+/* TEST_OPCOUNTS.CPP
+    Checks the operation counts (PB_INSTRUMENT) for a known press and release: update() counts one clock read per call
+      and a pin read per call outside debounce lockout, and each state change; a bank counts its shared port read and
+      timestamp in pbTotalOps only; resetOpCounts() clears the counts of one pushbutton.
+*/
+
+#include <string.h>
+#include "pbtest.h"
+#include "PushbuttonBank.h"
+
+const uint32_t runTime = 1000;  // ms
+const uint32_t pressTime = 100;
+const uint32_t releaseTime = 200;
+const uint32_t lockoutCalls = defDebouncePeriod + 1;   // calls skipped by each lockout (until now - start > period)
+
+  // Presses pin 1 (active LOW) from pressTime to releaseTime, with update() (bank == NULL) or bank->update() every ms
+static void runPress(pushButtonClass *btns, pushButtonBankClass *bank) {
+  for (hostMillis = 0; hostMillis < runTime; hostMillis++) {
+    if (hostMillis == pressTime)
+      hostPort &= ~(1 << 1);
+    if (hostMillis == releaseTime)
+      hostPort |= (1 << 1);
+    if (bank != NULL)
+      bank->update();
+    else
+      btns[0].update();
+  }
+}
+
+int main() {
+  pushButtonClass btns[2];
+  pushButtonBankClass bank;
+  pbOpCounts ops;
+
+    // update(): SINGLE_TAP only, so the press goes RDY -> WAIT_INACTIVE and the release goes back to RDY
+  hostReset();
+  hostPort = 0x6;   // pins 1-2 released
+  btns[0].init(1, LOW, true, SINGLE_TAP);
+  memset(&pbTotalOps, 0, sizeof(pbTotalOps));
+  runPress(btns, NULL);
+  btns[0].getOpCounts(ops);
+  CHECK_EQ(ops.updates, runTime);
+  CHECK_EQ(ops.clockReads, runTime);
+  CHECK_EQ(ops.lockoutSkips, 2 * lockoutCalls);
+  CHECK_EQ(ops.pinReads, runTime - 2 * lockoutCalls);
+  CHECK_EQ(ops.transitions, 2);
+  CHECK_EQ(pbTotalOps.pinReads, ops.pinReads);
+  CHECK_EQ(pbTotalOps.transitions, 2);
+
+  btns[0].resetOpCounts();
+  btns[0].getOpCounts(ops);
+  CHECK_EQ(ops.updates + ops.pinReads + ops.clockReads + ops.transitions + ops.lockoutSkips, 0);
+  CHECK_EQ(pbTotalOps.updates, runTime);  // not changed by resetOpCounts()
+
+    // Bank: one port read and one timestamp per scan, counted in pbTotalOps only
+  hostReset();
+  hostPort = 0x6;
+  btns[0].init(1, LOW, true, SINGLE_TAP);
+  btns[1].init(2, LOW, true, SINGLE_TAP);
+  bank.init(btns, 2);
+  memset(&pbTotalOps, 0, sizeof(pbTotalOps));
+  runPress(btns, &bank);
+  btns[0].getOpCounts(ops);
+  CHECK_EQ(ops.updates, runTime);
+  CHECK_EQ(ops.pinReads, 0);
+  CHECK_EQ(ops.clockReads, 0);
+  CHECK_EQ(ops.lockoutSkips, 2 * lockoutCalls);
+  CHECK_EQ(ops.transitions, 2);
+  btns[1].getOpCounts(ops);
+  CHECK_EQ(ops.updates, runTime);
+  CHECK_EQ(ops.lockoutSkips + ops.transitions, 0);
+  CHECK_EQ(pbTotalOps.pinReads, runTime);
+  CHECK_EQ(pbTotalOps.clockReads, runTime);
+  CHECK_EQ(pbTotalOps.updates, 2 * runTime);
+  return (testResult());
+}
@@ -0,0 +1,83 @@
+"""TEST_PBHOST.PY
+    Checks the host library through the ctypes wrapper (pbhost.py): pushbuttons are selected by bit position in the
+      samples (here bits above the board's pin range), the returned events match the pushbutton timing, the capture is
+      run again when the output buffer is too small, and NumPy inputs give a NumPy event array (skipped without NumPy).
+    Usage: test_pbhost.py <path to libpbhost>
+"""
+
+import os
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import pbhost
+from pbhost import PbHost, LOW, SINGLE_TAP, DOUBLE_TAP, LONG_PRESS
+
+failures = 0
+
+
+def check(cond, what):
+    global failures
+    if not cond:
+        print("FAIL: %s" % what)
+        failures += 1
+
+
+host = PbHost(sys.argv[1])
+
+# Bits 20 and 31 active LOW, 1 ms samples: bit 20 tapped at 100-200 ms, bit 31 held from 1000 to 2500 ms
+idle = (1 << 20) | (1 << 31)
+samples, times = [], []
+for t in range(4000):
+    s = idle
+    if 100 <= t < 200:
+        s &= ~(1 << 20)
+    if 1000 <= t < 2500:
+        s &= ~(1 << 31)
+    samples.append(s)
+    times.append(t)
+
+
+
+def records(ev):
+    """Returns the events as (time, pin, event) tuples, from a NumPy or ctypes array."""
+    if hasattr(ev, "dtype"):
+        return [(int(e["time"]), int(e["pin"]), int(e["event"])) for e in ev]
+    return [(e.time, e.pin, e.event) for e in ev]
+
+
+sel = SINGLE_TAP | DOUBLE_TAP | LONG_PRESS
+got = records(host.run(samples, times, pins=[20, 31], act_level=LOW, event_sel=sel))
+check(len(got) == 2, "2 events, got %r" % (got,))
+if len(got) == 2:
+    check((got[0][1], got[0][2]) == (20, SINGLE_TAP), "single tap on bit 20, got %r" % (got[0],))
+    check(200 <= got[0][0] <= 200 + 300 + 1, "single tap after the double-tap window, got %d" % got[0][0])
+    check((got[1][1], got[1][2]) == (31, LONG_PRESS), "long press on bit 31, got %r" % (got[1],))
+    check(got[1][0] == 1000 + 1000 + 1, "long press at 2001 ms, got %d" % got[1][0])
+
+check(len(host.run(samples, times, pins=[20], max_events=0)) == 0, "max_events=0 returns no events")
+check(records(host.run(samples, times, pins=[20, 31], event_sel=sel, max_events=1)) == got[:1],
+      "max_events=1 returns the first event")
+
+# Output buffer smaller than the number of events: the capture is run again
+pbhost.INITIAL_EVENTS = 1
+check(records(host.run(samples, times, pins=[20, 31], event_sel=sel)) == got, "all events with a 1-event first buffer")
+pbhost.INITIAL_EVENTS = 256
+
+# NumPy inputs and output
+if pbhost.np is None:
+    print("SKIP: NumPy case (NumPy not installed)")
+else:
+    np = pbhost.np
+    ev = host.run(np.array(samples, dtype=np.uint32), np.array(times, dtype=np.uint32), pins=[20, 31], event_sel=sel)
+    check(isinstance(ev, np.ndarray) and (ev.dtype == pbhost.EVENT_DTYPE), "NumPy array with EVENT_DTYPE")
+    check(records(ev) == got, "same events from NumPy inputs, got %r" % (records(ev),))
+    check(list(ev[ev["event"] == LONG_PRESS]["pin"]) == [31], "field access on the NumPy array")
+try:
+    host.run(samples, times, pins=[32])
+    check(False, "bit position 32 rejected")
+except ValueError:
+    pass
+
+if failures == 0:
+    print("PASS")
+sys.exit(1 if failures else 0)
@@ -0,0 +1,176 @@
+/* TEST_POOL.CPP
+    Checks that pushButtonPoolClass::add() and remove() keep the registries that refer to pool pushbuttons in step when
+      the last pushbutton is moved into a vacated slot: a bank pointer kept from getBank() scans exactly the active
+      pushbuttons, feedback outputs follow their pushbuttons (and the removed pushbutton's output is turned off and no
+      longer written, so its pin can be reused), captured edges reach the moved pushbutton, and the removed pushbutton's
+      capture slot and pin pullup are released.
+*/
+
+#include "pbtest.h"
+#include "PushbuttonPool.h"
+#include "PushbuttonRing.h"
+
+  // Counts the events of each pin in the ring (pins 0-7)
+static void drainRing(pushButtonRingClass &ring, int8_t sub, uint32_t *perPin) {
+  const pbEventRecord *r;
+
+  while ((r = ring.read(sub)) != NULL) {
+    if (r->pin < 8)
+      perPin[r->pin]++;
+  }
+}
+
+  // A bank pointer taken before remove() and add() must scan the active pushbuttons only, each once
+static void testBankPointer() {
+  pushButtonPoolClass pool;
+  pushButtonRingClass ring;
+  pushButtonBankClass *bank;
+  uint32_t perPin[8] = {0};
+  int8_t h0, h1, h2, sub;
+
+  hostReset();
+  hostPort = 0xE;   // pins 1-3 released (active LOW)
+  pool.init();
+  ring.init();
+  sub = ring.subscribe();
+  h0 = pool.add(0, 1, LOW, true, SINGLE_TAP);
+  h1 = pool.add(0, 2, LOW, true, SINGLE_TAP);
+  pool.get(h0)->attachRing(&ring);
+  pool.get(h1)->attachRing(&ring);
+  bank = pool.getBank();
+  CHECK_EQ(bank->getCount(), 2);
+  pool.remove(h0);  // h1 moves into slot 0; its old copy stays in slot 1
+  CHECK_EQ(bank->getCount(), 1);
+  CHECK_EQ(bank->getPortMask(), 1 << 2);
+  for (hostMillis = 0; hostMillis < 1000; hostMillis++) {
+    if (hostMillis == 10)
+      hostPort &= ~(1 << 2);
+    if (hostMillis == 100)
+      hostPort |= (1 << 2);
+    bank->update();
+  }
+  drainRing(ring, sub, perPin);
+  CHECK_EQ(perPin[2], 1);   // not twice (the old copy is not scanned)
+
+  h2 = pool.add(1, 3, LOW, true, SINGLE_TAP);   // an added pushbutton is scanned through the same pointer
+  pool.get(h2)->attachRing(&ring);
+  CHECK_EQ(bank->getCount(), 2);
+  CHECK_EQ(bank->getPortMask(), (1 << 2) | (1 << 3));
+  for (; hostMillis < 2000; hostMillis++) {
+    if (hostMillis == 1010)
+      hostPort &= ~(1 << 3);
+    if (hostMillis == 1100)
+      hostPort |= (1 << 3);
+    bank->update();
+  }
+  drainRing(ring, sub, perPin);
+  CHECK_EQ(perPin[2], 1);
+  CHECK_EQ(perPin[3], 1);
+}
+
+  // Feedback outputs, capture slots and pin modes across remove()
+static void testRegistries() {
+  pushButtonPoolClass pool;
+  pushButtonFeedbackClass fb;
+  int8_t h0, h1, h2, h3, c0, c2;
+
+  hostReset();
+  hostPort = 0x1E;  // pins 1-4 released (active LOW)
+  pool.init();
+  fb.init(FB_MOCK, NULL);
+  pool.attachFeedback(&fb);
+  h0 = pool.add(0, 1, LOW, true, SINGLE_TAP);
+  h1 = pool.add(0, 2, LOW, true, SINGLE_TAP);
+  h2 = pool.add(1, 3, LOW, true, SINGLE_TAP | LONG_PRESS);
+  CHECK((h0 >= 0) && (h1 >= 0) && (h2 >= 0));
+  pool.setOutput(h0, 0);
+  pool.setOutput(h1, 1);
+  pool.setOutput(h2, 2);
+  c0 = pushButtonCaptureClass::attach(pool.get(h0));
+  c2 = pushButtonCaptureClass::attach(pool.get(h2));
+  CHECK((c0 >= 0) && (c2 >= 0));
+
+  hostMillis = 10;
+  hostPort &= ~(1 << 1);  // press h0: its output lights
+  pool.update();
+  CHECK_EQ(fb.mockBits(), 1 << 0);
+
+  pool.remove(h0);  // h2 moves into h0's slot
+  CHECK(pool.get(h0) == NULL);
+  CHECK_EQ(pool.getCount(), 2);
+  CHECK_EQ(hostPinMode[1], INPUT);
+  hostMillis = 11;
+  pool.update();
+  CHECK_EQ(fb.mockBits(), 0);   // removed pushbutton's output turned off, moved pushbutton's output still off
+
+  hostMillis = 15;   // captured edges reach the moved pushbutton
+  hostMicros = 15000;
+  hostPort &= ~(1 << 3);  // press h2
+  pushButtonCaptureClass::mockEdge(c2, LOW, 14500);
+  pool.get(h2)->updateEdges();
+  CHECK_EQ(pool.get(h2)->pressMicros(), 14500);
+  CHECK_EQ(pool.get(h2)->pNum, 3);
+
+  hostMillis = 20;  // h2's own output lights, not the one of h0's old slot
+  pool.update();
+  CHECK_EQ(fb.mockBits(), 1 << 2);
+
+  h3 = pool.add(2, 4, LOW, true, SINGLE_TAP);   // h0's capture slot was freed
+  CHECK(h3 >= 0);
+  CHECK_EQ(pushButtonCaptureClass::attach(pool.get(h3)), c0);
+
+  CHECK_EQ(pool.removeModule(0), 1);  // h1
+  CHECK(pool.get(h1) == NULL);
+  CHECK_EQ(pool.get(h2)->pNum, 3);
+  CHECK_EQ(pool.get(h3)->pNum, 4);
+  pushButtonCaptureClass::detach(pool.get(h2));
+  pushButtonCaptureClass::detach(pool.get(h3));
+}
+
+  // FB_PORT: a removed pushbutton's output pin is turned off and left alone by later port writes
+static void testPortOutputs() {
+  pushButtonPoolClass pool;
+  pushButtonFeedbackClass fb;
+  int8_t h0, h1, h2;
+
+  hostReset();
+  hostPort = 0xE;   // pins 1-3 released (active LOW)
+  pool.init();
+  fb.init(FB_PORT, NULL);
+  pool.attachFeedback(&fb);
+  h0 = pool.add(0, 1, LOW, true, SINGLE_TAP);
+  h1 = pool.add(0, 2, LOW, true, SINGLE_TAP);
+  pool.setOutput(h0, 8);
+  pool.setOutput(h1, 9);
+
+  hostMillis = 10;
+  hostPort &= ~(1 << 1);  // press h0: output pin 8 on
+  pool.update();
+  CHECK_EQ(hostPortSet, 1 << 8);
+  CHECK_EQ(hostPortClear, 1 << 9);
+
+  pool.remove(h0);  // h1 moves into h0's slot
+  CHECK_EQ(hostPortClear, 1 << 8);  // turned off at once
+  hostPortSet = 0;
+  hostPortClear = 0;
+  hostMillis = 20;
+  hostPort &= ~(1 << 2);  // press h1: only pin 9 is written
+  pool.update();
+  CHECK_EQ(hostPortSet, 1 << 9);
+  CHECK_EQ(hostPortClear, 0);
+
+  h2 = pool.add(1, 3, LOW, true, SINGLE_TAP);   // pin 8 reused by another pushbutton
+  pool.setOutput(h2, 8);
+  hostMillis = 30;
+  hostPort &= ~(1 << 3);  // press h2 (h1 still pressed)
+  pool.update();
+  CHECK_EQ(hostPortSet, (1 << 8) | (1 << 9));
+  CHECK_EQ(hostPortClear, 0);
+}
+
+int main() {
+  testBankPointer();
+  testRegistries();
+  testPortOutputs();
+  return (testResult());
+}
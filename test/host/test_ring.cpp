@@ -0,0 +1,127 @@
+/* TEST_RING.CPP
+    Checks pushButtonRingClass: broadcast delivery to several subscribers, overrun counting, the documented lifetime of
+      the records returned by read(), and that coalescing never hides an event from any subscriber.
+*/
+
+#include "pbtest.h"
+#include "PushbuttonRing.h"
+
+  // Publishes n events with consecutive times starting at t
+static void publishN(pushButtonRingClass &ring, uint32_t n, uint32_t &t) {
+  while (n--) {
+    ring.publish(1, SINGLE_TAP, t);
+    t++;
+  }
+}
+
+static void testBroadcast() {
+  pushButtonRingClass ring;
+  const pbEventRecord *r;
+  int8_t a, b;
+  uint32_t t = 0, i;
+
+  ring.init();
+  a = ring.subscribe();
+  b = ring.subscribe();
+  publishN(ring, 5, t);
+  CHECK_EQ(ring.available(a), 5);
+  CHECK_EQ(ring.available(b), 5);
+  for (i = 0; i < 5; i++) {
+    r = ring.read(a);
+    CHECK((r != NULL) && (r->time == i));
+  }
+  CHECK(ring.read(a) == NULL);
+  CHECK_EQ(ring.available(b), 5);   // each subscriber has its own cursor
+
+    // b falls behind by more than a full ring: the oldest events are counted as overruns
+  publishN(ring, ringSize, t);
+  CHECK_EQ(ring.available(b), ringSize);
+  r = ring.read(b);
+  CHECK_EQ(ring.overruns(b), 5);
+  CHECK((r != NULL) && (r->time == 5));
+  CHECK_EQ(ring.overruns(a), 0);
+}
+
+static void testLifetime() {
+  pushButtonRingClass ring;
+  const pbEventRecord *r;
+  uint32_t t = 0, n, k, time;
+  int8_t sub;
+
+  for (n = 1; n <= ringSize; n++) {   // n unread events before read()
+    ring.init();
+    sub = ring.subscribe();
+    publishN(ring, n, t);
+    CHECK_EQ(ring.available(sub), n);
+    r = ring.read(sub);
+    time = r->time;
+    for (k = 0; k < (ringSize - n); k++) {  // valid for (ringSize - n) more publishes
+      ring.publish(1, SINGLE_TAP, 1000000);
+      CHECK_EQ(r->time, time);
+    }
+    ring.publish(1, SINGLE_TAP, 1000000);   // then the slot is reused
+    CHECK_EQ(r->time, 1000000);
+  }
+}
+
+  // Total number of events (records plus merged counts) read by a subscriber
+static uint32_t drainCount(pushButtonRingClass &ring, int8_t sub) {
+  const pbEventRecord *r;
+  uint32_t n = 0;
+
+  while ((r = ring.read(sub)) != NULL)
+    n += r->count;
+  return (n);
+}
+
+static void testCoalescing() {
+  pushButtonRingClass ring;
+  const pbEventRecord *r;
+  uint32_t fastSeen, i;
+  int8_t fast, slow;
+
+  ring.init();
+  ring.setCoalescing(1);
+  fast = ring.subscribe();
+  slow = ring.subscribe();
+
+    // Nobody has read the newest record: identical events are merged
+  ring.publish(1, SINGLE_TAP, 0);
+  ring.publish(1, SINGLE_TAP, 10);
+  CHECK_EQ(ring.coalesced(), 1);
+  CHECK_EQ(ring.available(fast), 1);
+  r = ring.read(fast);
+  CHECK((r != NULL) && (r->count == 2) && (r->time == 0));
+
+    // The fast subscriber has read the newest record: a new identical event gets its own record
+  ring.publish(1, SINGLE_TAP, 20);
+  CHECK_EQ(ring.coalesced(), 1);
+  CHECK_EQ(ring.available(fast), 1);
+  r = ring.read(fast);
+  CHECK((r != NULL) && (r->count == 1) && (r->time == 20));
+  CHECK_EQ(drainCount(ring, slow), 3);
+
+    // Mixed reading pattern: every subscriber sees every published event
+  fastSeen = 0;
+  for (i = 0; i < 1000; i++) {
+    ring.publish(1, ((i % 7) == 0) ? DOUBLE_TAP : SINGLE_TAP, i);
+    if ((i % 3) == 0)
+      fastSeen += drainCount(ring, fast);
+    if ((i % 11) == 0) {
+      CHECK_EQ(ring.overruns(slow), 0);
+      drainCount(ring, slow);
+    }
+  }
+  fastSeen += drainCount(ring, fast);
+  CHECK_EQ(fastSeen, 1000);
+  CHECK_EQ(ring.overruns(fast), 0);
+  CHECK(ring.coalesced() > 1);
+}
+
+int main() {
+  hostReset();
+  testBroadcast();
+  testLifetime();
+  testCoalescing();
+  return (testResult());
+}
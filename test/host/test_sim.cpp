@@ -0,0 +1,90 @@
+/* TEST_SIM.CPP
+    Checks pushButtonSimClass checkpoints: after a full run, seek() to a late time and replaying to the end must give the
+      same events as the full run from the restored checkpoint onwards, with far fewer steps. Also checks that the
+      checkpoint buffer thins out (interval doubling) without losing the ability to seek. Runs with and without
+      DOUBLE_TAP_HOLD enabled, on a trace that includes tap-then-hold gestures.
+*/
+
+#include "pbtest.h"
+#include <vector>
+#include "PushbuttonSim.h"
+
+const uint32_t maxEvents = 20000;
+const uint32_t idlePort = 0x6;    // pins 1 and 2, active LOW
+const uint32_t endTime = 86400000;
+
+static pbEventRecord fullEvents[maxEvents], tailEvents[maxEvents];
+static pbSimCheckpoint ckpt[16];
+
+  // Full run, then seek() and replay to the end, with eventSel on the first pushbutton
+static void checkSeek(const std::vector<pbTraceEdge> &trace, int eventSel) {
+  pushButtonClass btn[2];
+  pushButtonBankClass bank;
+  pushButtonSimClass sim;
+  uint32_t nFull, nTail, fullSteps, from, k, i;
+  uint32_t seekTimes[3] = {80000000, 43200000, 0};
+  uint8_t s;
+
+  btn[0].init(1, LOW, true, eventSel);
+  btn[1].init(2, LOW, true, SINGLE_TAP | LONG_PRESS);
+  bank.init(btn, 2);
+  sim.init(&bank, trace.data(), trace.size(), idlePort);
+  CHECK(sim.setCheckpoints(ckpt, 16, 60000));   // 24 h / 1 min needs many thinning passes
+  nFull = sim.run(endTime + 5000, fullEvents, maxEvents);
+  fullSteps = sim.steps();
+  CHECK(nFull > 0);
+  if (eventSel & DOUBLE_TAP_HOLD) {
+    for (k = 0; (k < nFull) && (fullEvents[k].event != DOUBLE_TAP_HOLD); k++)
+      ;
+    CHECK(k < nFull);   // the trace's tap-then-hold gestures are detected
+  }
+
+  seekTimes[2] = trace[0].time;   // first checkpoint
+  for (s = 0; s < 3; s++) {
+    CHECK(sim.seek(seekTimes[s]));
+    from = sim.time();
+    CHECK(from <= seekTimes[s]);
+    k = sim.steps();
+    nTail = sim.run(endTime + 5000, tailEvents, maxEvents);
+    if (s == 0)
+      CHECK((sim.steps() - k) < (fullSteps / 4));  // replaying the window is much cheaper than starting over
+    for (k = 0; (k < nFull) && (fullEvents[k].time < from); k++)
+      ;
+    CHECK_EQ(nTail, nFull - k);
+    for (i = 0; (i < nTail) && ((k + i) < nFull); i++) {
+      if ((tailEvents[i].time != fullEvents[k + i].time) || (tailEvents[i].pin != fullEvents[k + i].pin) ||
+          (tailEvents[i].event != fullEvents[k + i].event)) {
+        printf("seek(%u): event %u differs\n", seekTimes[s], i);
+        pbTestFailures++;
+        break;
+      }
+    }
+  }
+  CHECK(!sim.seek(trace[0].time - 1));   // no checkpoint before the start of the trace
+}
+
+int main() {
+  std::vector<pbTraceEdge> trace;
+  uint32_t t = 0, port = idlePort, pin, n = 0;
+
+  hostReset();
+  srand(7);
+  while (true) {
+    t += ((rand() % 3) == 0) ? (rand() % 600000) : ((rand() % 1500) + 1);
+    if (t >= endTime)
+      break;
+    pin = 1 + (rand() % 2);
+    port ^= (1 << pin);
+    trace.push_back({t, port});
+    if (((++n % 4) == 0) && (port & (1 << 1)) && ((t + 3000) < endTime)) {  // tap, then press and hold on pin 1
+      trace.push_back({t + 1000, port & ~(1 << 1)});
+      trace.push_back({t + 1100, port});
+      trace.push_back({t + 1200, port & ~(1 << 1)});
+      t += 2700;
+      trace.push_back({t, port});
+    }
+  }
+  checkSeek(trace, SINGLE_TAP | DOUBLE_TAP | LONG_PRESS);
+  checkSeek(trace, SINGLE_TAP | DOUBLE_TAP | LONG_PRESS | DOUBLE_TAP_HOLD);
+  return (testResult());
+}